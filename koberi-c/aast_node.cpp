@@ -34,6 +34,12 @@ std::string translateType(const std::string & type) {
         t = syntax::uintType;
     } else if (t == "num") {
         t = syntax::floatType;
+    } else if (syntax::sizedTypes.count(t)) {
+        t = syntax::sizedTypes.at(t);
+    } else if (syntax::vectorTypes.count(t)) {
+        t += syntax::vectorTypeSuffix;
+    } else if (t == syntax::coroutine) {
+        t = syntax::coroutineType + syntax::pointerChar;
     }
     
     if (isPtr) {
@@ -70,6 +76,10 @@ AASTScope::~AASTScope() {
     
 }
 
+std::vector<AASTNode *> & AASTScope::getBody() {
+    return _body;
+}
+
 std::string AASTScope::value(int baseIndent) const {
     
     std::stringstream stream;
@@ -92,20 +102,107 @@ std::string AASTScope::value(int baseIndent) const {
 }
 
 AASTConstruct::AASTConstruct(const std::string & construct,
-                             const AASTNode * condition,
-                             const AASTScope * body) : _construct(construct),
+                             AASTNode * condition,
+                             AASTScope * body) : _construct(construct),
                                                        _condition(condition),
                                                        _body(body),
                                                        AASTNode(AASTNodeType::Construct, "") { }
 
+AASTConstruct::AASTConstruct(const std::string & construct,
+                             AASTNode * condition,
+                             AASTScope * body,
+                             const std::vector<AASTDeclaration *> & initializers,
+                             AASTNode * increment) : AASTNode(AASTNodeType::Construct, ""),
+                                                     _construct(construct),
+                                                     _condition(condition),
+                                                     _body(body),
+                                                     _initializers(initializers),
+                                                     _increment(increment) { }
+
 AASTConstruct::~AASTConstruct() {
+    
     delete _condition;
+    delete _increment;
+    
+    for (AASTDeclaration * initializer : _initializers) {
+        delete initializer;
+    }
+    
+}
+
+const std::string & AASTConstruct::getConstruct() const {
+    return _construct;
+}
+
+AASTNode *& AASTConstruct::getCondition() {
+    return _condition;
+}
+
+AASTScope *& AASTConstruct::getBody() {
+    return _body;
+}
+
+std::vector<AASTDeclaration *> & AASTConstruct::getInitializers() {
+    return _initializers;
+}
+
+AASTNode *& AASTConstruct::getIncrement() {
+    return _increment;
+}
+
+void AASTConstruct::setBranchCounter(int index) {
+    _branchCounter = index;
+}
+
+void AASTConstruct::setExpected(int expected) {
+    _expected = expected;
+}
+
+void AASTConstruct::setOptions(const Options & options) {
+    _options = options;
+}
+
+void AASTConstruct::setReductions(const std::map<std::string, std::string> & reductions) {
+    _reductions = reductions;
+}
+
+std::string AASTConstruct::parallelFor(int baseIndent) const {
+    
+    std::stringstream stream;
+    
+    AASTDeclaration * variable = _initializers[0];
+    
+    stream << "{" << "\n";
+    stream << indent(baseIndent + 1) << translateType(variable->type()) << " " << variable->getName() << ";" << "\n";
+    
+    /* Bounds are evaluated once and shared by all threads */
+    for (size_t i = 1; i < _initializers.size(); ++i) {
+        stream << indent(baseIndent + 1) << _initializers[i]->value(0) << ";" << "\n";
+    }
+    
+    stream << indent(baseIndent + 1) << "#pragma omp parallel for private(" << variable->getName() << ")";
+    
+    for (const auto & reduction : _reductions) {
+        stream << " reduction(" << reduction.second << ":" << reduction.first << ")";
+    }
+    
+    stream << "\n" << indent(baseIndent + 1) << "for (" << variable->getName() << " = "
+           << variable->getValue()->value(0) << "; " << _condition->value(0) << "; " << _increment->value(0) << ")";
+    stream << _body->value(baseIndent + 1);
+    stream << indent(baseIndent) << "}";
+    
+    return stream.str();
+    
 }
 
 std::string AASTConstruct::value(int baseIndent) const {
     
     std::stringstream stream;
     
+    if (_construct == "pfor") {
+        return parallelFor(baseIndent);
+    }
+    
     std::string construct = _construct;
     
     if (_construct == "elif") {
@@ -114,10 +211,62 @@ std::string AASTConstruct::value(int baseIndent) const {
         construct = "do";
     }
     
+    /* GCC has no pragma which enables vectorization of a single loop, it relies on -O3 or -ftree-vectorize */
+    /* Clang doesn't know #pragma GCC ivdep, it allows vectorization without dependency checks instead    */
+    std::vector<std::string> pragmas;
+    
+    if (_options.count("unroll")) {
+        pragmas.emplace_back("#pragma GCC unroll " + _options.at("unroll"));
+    }
+    
+    if (_options.count("ivdep")) {
+        pragmas.insert(pragmas.end(), { "#if defined(__clang__)", "#pragma clang loop vectorize(assume_safety)",
+                                        "#else", "#pragma GCC ivdep", "#endif" });
+    } else if (_options.count("vectorize")) {
+        pragmas.insert(pragmas.end(), { "#if defined(__clang__)", "#pragma clang loop vectorize(enable)", "#endif" });
+    }
+    
+    for (const std::string & pragma : pragmas) {
+        stream << pragma << "\n" << indent(baseIndent);
+    }
+    
     stream << indent(baseIndent - 1) << construct;
     
-    if (construct != "else" and construct != "do") {
-        stream << " (" << _condition->value(0) << ")";
+    /* All initializers are of the same type, the type is only written once */
+    if (construct == "for") {
+        
+        stream << " (";
+        
+        for (size_t i = 0; i < _initializers.size(); ++i) {
+            
+            const std::string declaration = _initializers[i]->value(0);
+            
+            if (i == 0) {
+                stream << declaration;
+            } else {
+                stream << ", " << declaration.substr(translateType(_initializers[i]->type()).size() + 1);
+            }
+            
+        }
+        
+        stream << "; " << _condition->value(0) << "; " << _increment->value(0) << ")";
+        
+    }
+    
+    else if (construct != "else" and construct != "do") {
+        
+        std::string condition = _condition->value(0);
+        
+        if (_branchCounter >= 0) {
+            condition = syntax::profileBranch + "(_prof__branches[" + std::to_string(_branchCounter) + "], !!(" +
+                        condition + "))";
+        }
+        
+        if (_expected >= 0) {
+            condition = "__builtin_expect(!!(" + condition + "), " + std::to_string(_expected) + ")";
+        }
+        
+        stream << " (" << condition << ")";
     }
     
     stream << _body->value(baseIndent);
@@ -133,16 +282,221 @@ std::string AASTConstruct::value(int baseIndent) const {
 AASTFunction::AASTFunction(const std::string & name,
                            const std::string & type,
                            const std::vector<AASTDeclaration> & parameters,
-                           const AASTScope * body) : _mangledName(name),
-                                                     _parameters(parameters),
-                                                     _body(body),
-                                                     AASTNode(AASTNodeType::Function, type) { }
+                           AASTScope * body,
+                           bool isExported) : AASTNode(AASTNodeType::Function, type),
+                                              _mangledName(name),
+                                              _parameters(parameters),
+                                              _body(body),
+                                              _isExported(isExported) { }
+
+const std::string & AASTFunction::getName() const {
+    return _mangledName;
+}
+
+AASTScope * AASTFunction::getBody() {
+    return _body;
+}
+
+bool AASTFunction::isExported() const {
+    return _isExported;
+}
+
+bool AASTFunction::isInline() const {
+    return _isInline;
+}
+
+void AASTFunction::setInline(bool isInline) {
+    _isInline = isInline;
+}
+
+void AASTFunction::setProfileName(const std::string & name, int branchCount) {
+    _profileName = name;
+    _branchCount = branchCount;
+}
+
+bool AASTFunction::isInstrumented() const {
+    return _profileName != "";
+}
+
+bool AASTFunction::isHot() const {
+    return _isHot;
+}
+
+bool AASTFunction::isCold() const {
+    return _isCold;
+}
+
+void AASTFunction::setHot(bool isHot) {
+    _isHot = isHot;
+}
+
+void AASTFunction::setCold(bool isCold) {
+    _isCold = isCold;
+}
+
+bool AASTFunction::spawnsTasks() const {
+    return _spawnsTasks;
+}
+
+void AASTFunction::setSpawnsTasks(bool spawnsTasks) {
+    _spawnsTasks = spawnsTasks;
+}
+
+bool AASTFunction::isAsync() const {
+    return _isAsync;
+}
+
+void AASTFunction::setCoroutine(const std::vector<AASTDeclaration> & frame, size_t suspendPoints) {
+    _isAsync = true;
+    _frame.clear();
+    
+    for (const AASTDeclaration & variable : frame) {
+        _frame.emplace_back(variable);
+    }
+    
+    _suspendPoints = suspendPoints;
+}
 
 std::string AASTFunction::value(int baseIndent) const {
     
     std::stringstream stream;
     
-    stream << declaration() << _body->value(baseIndent);
+    if (_isAsync) {
+        return coroutine(baseIndent);
+    }
+    
+    if (_profileName == "" and not _spawnsTasks) {
+        stream << declaration() << _body->value(baseIndent);
+        return stream.str();
+    }
+    
+    stream << declaration() << "\n" << indent(baseIndent) << "{" << "\n";
+    stream << prologue(baseIndent + 1);
+    stream << _body->value(baseIndent + 1);
+    stream << indent(baseIndent) << "}" << "\n";
+    
+    return stream.str();
+    
+}
+
+std::string AASTFunction::prologue(int baseIndent) const {
+    
+    std::stringstream stream;
+    
+    /* The frame is closed by a cleanup handler, so every return is measured, including return values */
+    if (_profileName != "") {
+        
+        if (_branchCount) {
+            stream << indent(baseIndent) << "static uint64_t _prof__branches[" << _branchCount << "][2];" << "\n";
+        }
+        
+        stream << indent(baseIndent) << "static " << syntax::profileEntry << " _prof__entry = { \""
+               << _profileName << "\", \"" << _mangledName << "\", " << _branchCount << ", "
+               << (_branchCount ? "_prof__branches" : "NULL") << ", 0, 0, 0, NULL };" << "\n";
+        stream << indent(baseIndent) << "static _Thread_local uint64_t _prof__depth;" << "\n";
+        stream << indent(baseIndent) << syntax::profileFrame << " _prof__frame __attribute__((cleanup("
+               << syntax::profileExit << ")));" << "\n";
+        stream << indent(baseIndent) << syntax::profileEnter << "(&_prof__frame, &_prof__entry, &_prof__depth);" << "\n";
+    }
+    
+    /* Tasks may still be running when the function returns, the cleanup handler waits for them */
+    if (_spawnsTasks) {
+        stream << indent(baseIndent) << syntax::taskGroup << " " << syntax::taskGroupVariable
+               << " __attribute__((cleanup(" << syntax::taskSync << "))) = { 0 };" << "\n";
+    }
+    
+    return stream.str();
+    
+}
+
+std::string AASTFunction::coroutine(int baseIndent) const {
+    
+    std::stringstream stream;
+    
+    const std::string frame = NameMangler::coroutineFrameName(_mangledName);
+    const std::string resume = NameMangler::coroutineResumeName(_mangledName);
+    const std::string & coroutine = syntax::coroutineVariable;
+    const std::string & frameVariable = syntax::coroutineFrameVariable;
+    
+    const std::string body = _body->value(baseIndent + 1);
+    
+    /* Resume function returns 1 if the coroutine suspended and 0 if it finished, finished coroutines */
+    /* have their state set to -1, other states are indices of suspension points                     */
+    stream << "static " << translateType("int") << " " << resume << "(" << syntax::coroutineType << " * "
+           << coroutine << ")" << "\n" << indent(baseIndent) << "{" << "\n";
+    
+    stream << prologue(baseIndent + 1);
+    stream << indent(baseIndent + 1) << frame << " * " << frameVariable << " = (" << frame << " *)" << coroutine
+           << ";" << "\n";
+    
+    for (const AASTDeclaration & param : _parameters) {
+        stream << indent(baseIndent + 1) << param.value() << " = " << frameVariable << "->" << param.getName()
+               << ";" << "\n";
+    }
+    
+    /* Jump to the suspension point, suspension points removed by the optimizer don't have a label */
+    stream << indent(baseIndent + 1) << "switch (" << coroutine << "->state) {" << "\n";
+    
+    for (size_t i = 1; i <= _suspendPoints; ++i) {
+        
+        const std::string label = NameMangler::suspendLabel(i);
+        
+        if (body.find(label + ":") != std::string::npos) {
+            stream << indent(baseIndent + 2) << "case " << i << ": goto " << label << ";" << "\n";
+        }
+        
+    }
+    
+    stream << indent(baseIndent + 1) << "}" << "\n";
+    
+    stream << body;
+    stream << indent(baseIndent + 1) << coroutine << "->state = -1;" << "\n";
+    stream << indent(baseIndent + 1) << "return 0;" << "\n";
+    stream << indent(baseIndent) << "}" << "\n" << "\n";
+    
+    /* Async function only allocates the frame and stores parameters, the coroutine starts when it's resumed */
+    stream << declaration() << "\n" << indent(baseIndent) << "{" << "\n";
+    
+    stream << indent(baseIndent + 1) << frame << " * " << frameVariable << " = " << syntax::memoryAlloc
+           << "(sizeof(" << frame << "), NULL);" << "\n";
+    stream << indent(baseIndent + 1) << frameVariable << "->" << coroutine << " = (" << syntax::coroutineType
+           << "){ 0, " << resume << ", NULL };" << "\n";
+    
+    for (const AASTDeclaration & param : _parameters) {
+        stream << indent(baseIndent + 1) << frameVariable << "->" << param.getName() << " = " << param.getName()
+               << ";" << "\n";
+    }
+    
+    stream << indent(baseIndent + 1) << "return &" << frameVariable << "->" << coroutine << ";" << "\n";
+    stream << indent(baseIndent) << "}" << "\n";
+    
+    return stream.str();
+    
+}
+
+std::string AASTFunction::frame() const {
+    
+    std::stringstream stream;
+    
+    const std::string frame = NameMangler::coroutineFrameName(_mangledName);
+    
+    /* Coroutine header comes first, so frames can be accessed through pointers to their coroutines */
+    stream << "typedef struct " << frame << "\n" << "{" << "\n";
+    stream << indent(1) << syntax::coroutineType << " " << syntax::coroutineVariable << ";\n";
+    
+    if (type() != "void") {
+        stream << indent(1) << AASTDeclaration(syntax::coroutineResult, type(), nullptr).value() << ";\n";
+    }
+    
+    for (const AASTDeclaration & param : _parameters) {
+        stream << indent(1) << param.value() << ";\n";
+    }
+    
+    for (const AASTDeclaration & variable : _frame) {
+        stream << indent(1) << variable.value() << ";\n";
+    }
+    
+    stream << "} " << frame << ";" << "\n";
     
     return stream.str();
     
@@ -152,7 +506,18 @@ std::string AASTFunction::declaration() const {
     
     std::stringstream stream;
     
-    stream << translateType(type()) << " " << _mangledName << "(";
+    if (not _isExported) {
+        stream << (_isInline ? "static inline " : "static ");
+    }
+    
+    if (_isHot) {
+        stream << "__attribute__((hot)) ";
+    } else if (_isCold) {
+        stream << "__attribute__((cold)) ";
+    }
+    
+    /* Async functions return the created coroutine */
+    stream << translateType(_isAsync ? syntax::coroutine : type()) << " " << _mangledName << "(";
     
     for (size_t i = 0; i < _parameters.size(); ++i) {
         
@@ -175,13 +540,39 @@ AASTClass::AASTClass(const std::string & name,
                                           _vtable(vt),
                                           AASTNode(AASTNodeType::Class, name) { }
 
+bool AASTClass::isInstantiated() const {
+    return _isInstantiated;
+}
+
+void AASTClass::setInstantiated(bool instantiated) {
+    _isInstantiated = instantiated;
+}
+
+bool AASTClass::hasSoa() const {
+    return _hasSoa;
+}
+
+void AASTClass::setSoa(bool hasSoa) {
+    _hasSoa = hasSoa;
+}
+
+size_t AASTClass::alignment() const {
+    return _alignment;
+}
+
+void AASTClass::setAlignment(size_t alignment) {
+    _alignment = alignment;
+}
+
 std::string AASTClass::value(int baseIndent) const {
     
     std::stringstream stream;
     
     stream << "typedef struct " << _name << "\n" << "{" << "\n";
     
-    stream << indent(baseIndent + 1) << "void (**vtable)(void)" << ";\n";
+    /* Aligning the first member aligns the whole struct */
+    stream << indent(baseIndent + 1) << (_alignment ? "_Alignas(" + std::to_string(_alignment) + ") " : "")
+           << "void (**vtable)(void)" << ";\n";
     
     for (const AASTDeclaration & attribute : _attributes) {
         stream << indent(baseIndent + 1) << attribute.value(baseIndent + 1) << ";\n";
@@ -189,6 +580,25 @@ std::string AASTClass::value(int baseIndent) const {
     
     stream << "} " << _name << ";" << "\n";
     
+    /* Struct-of-arrays container holds one array per attribute */
+    if (_hasSoa) {
+        
+        const std::string soa = _name + syntax::soaSuffix;
+        
+        stream << "\n" << "typedef struct " << soa << "\n" << "{" << "\n";
+        stream << indent(baseIndent + 1) << translateType("int") << " " << syntax::soaLength << ";\n";
+        
+        for (const AASTDeclaration & attribute : _attributes) {
+            
+            const AASTDeclaration column(attribute.getName(), syntax::pointerForType(attribute.type()), nullptr);
+            stream << indent(baseIndent + 1) << column.value(baseIndent + 1) << ";\n";
+            
+        }
+        
+        stream << "} " << soa << ";" << "\n";
+        
+    }
+    
     return stream.str();
     
 }
@@ -197,7 +607,7 @@ std::string AASTClass::vtable() const {
     
     /* Inserting whitespace after { so when trailing commas are being removed, the whitespace */
     /* Character will be removed instead of the brace { */
-    std::string table = "void (*" + NameMangler::vtableName(_name) +"[])(void) = { \n";
+    std::string table = "static void (*" + NameMangler::vtableName(_name) +"[])(void) = { \n";
     
     std::vector<std::string> methods;
     
@@ -214,6 +624,11 @@ std::string AASTClass::vtable() const {
         
     }
     
+    /* Empty vtables still need an entry, so every class' vtable has a distinct address */
+    if (methods.empty()) {
+        methods.emplace_back("0");
+    }
+    
     for (const auto & m : methods) {
         table += indent(1) + m + ",\n";
     }
@@ -241,6 +656,14 @@ AASTFuncall::~AASTFuncall() {
     
 }
 
+const std::string & AASTFuncall::getName() const {
+    return _mangledName;
+}
+
+std::vector<AASTNode *> & AASTFuncall::getParameters() {
+    return _parameters;
+}
+
 std::string AASTFuncall::value(int baseIndent) const {
     
     std::stringstream stream;
@@ -277,19 +700,82 @@ std::string AASTValue::value(int baseIndent) const {
 
 AASTDeclaration::AASTDeclaration(const std::string & name,
                                  const std::string & type,
-                                 const AASTNode * value) : _name(name),
+                                 AASTNode * value) : _name(name),
                                                            _value(value),
                                                            AASTNode(AASTNodeType::Declaration, type) { }
 
+AASTDeclaration::AASTDeclaration(const std::string & name,
+                                 const std::string & type,
+                                 AASTNode * value,
+                                 const type_qualifiers & qualifiers) : AASTNode(AASTNodeType::Declaration, type),
+                                                                      _name(name),
+                                                                      _value(value),
+                                                                      _qualifiers(qualifiers) { }
+
+AASTDeclaration::AASTDeclaration(const std::string & name,
+                                 const std::string & type,
+                                 AASTNode * value,
+                                 AASTNode * length,
+                                 bool onHeap) : AASTNode(AASTNodeType::Declaration, type),
+                                                _name(name),
+                                                _value(value),
+                                                _length(length),
+                                                _onHeap(onHeap) { }
+
 AASTDeclaration::~AASTDeclaration() {
     delete _value;
+    delete _length;
+}
+
+const std::string & AASTDeclaration::getName() const {
+    return _name;
+}
+
+AASTNode *& AASTDeclaration::getLength() {
+    return _length;
+}
+
+AASTNode *& AASTDeclaration::getValue() {
+    return _value;
 }
 
 std::string AASTDeclaration::value(int baseIndent) const {
     
     std::stringstream stream;
     
-    stream << translateType(type()) << " " << _name;
+    if (_qualifiers.isThreadLocal) {
+        stream << "_Thread_local ";
+    }
+    
+    if (_qualifiers.alignment) {
+        stream << "_Alignas(" << _qualifiers.alignment << ") ";
+    }
+    
+    if (_length != nullptr and not _onHeap) {
+        
+        std::string elementType = type();
+        elementType.pop_back();
+        
+        stream << translateType(elementType) << " " << _name << "[" << _length->value(baseIndent + 1) << "]";
+        
+    } else if (_length != nullptr) {
+        
+        stream << translateType("int") << " " << NameMangler::arrayLengthName(_name) << " = "
+               << _length->value(baseIndent + 1) << "; ";
+        stream << translateType(type()) << " " << _name;
+        
+    } else if (_qualifiers.isAtomic) {
+        
+        /* Type specifier form makes the variable itself atomic, even if it's a pointer */
+        stream << "_Atomic(" << translateType(type()) << ") " << _name;
+        
+    } else {
+        
+        /* const qualifies values pointers point to, restrict qualifies pointers */
+        stream << (_qualifiers.isConst ? "const " : "") << translateType(type())
+               << (_qualifiers.isRestrict ? " restrict " : " ") << _name;
+        
+    }
     
     if (_value != nullptr) {
         stream << " = " << _value->value(baseIndent + 1);
@@ -319,16 +805,27 @@ const std::string & AASTOperator::getOperator() const {
     
 }
 
+std::vector<AASTNode *> & AASTOperator::getParameters() {
+    
+    return _parameters;
+    
+}
+
 void unaryOperator(std::stringstream & stream, const std::string & op, const parameter & parameter);
 
+bool isComparison(const std::string & op);
+
+void comparison(std::stringstream & stream,
+                const std::string & op,
+                const std::vector<parameter> & parameters,
+                const std::vector<AASTNode *> & nodes);
+
 void binaryOperator(std::stringstream & stream,
                     const std::string & op,
                     std::vector<parameter> & parameters);
 
 void inlineC(std::stringstream & stream, const std::vector<parameter> & values, const int indentLevel);
 
-void print(std::stringstream & stream, const std::vector<parameter> & values, const int indentLevel);
-
 void _new(std::stringstream & stream, const std::vector<parameter> & values, const int indentLevel);
 
 std::string AASTOperator::value(int baseIndent) const {
@@ -348,8 +845,8 @@ std::string AASTOperator::value(int baseIndent) const {
         _new(stream, values, baseIndent);
     }
     
-    else if (_operator == "print") {
-        print(stream, values, baseIndent);
+    else if (_operator == "[]") {
+        stream << values[0].value << "[" << values[1].value << "]";
     }
     
     else if (not values.size()) {
@@ -360,6 +857,10 @@ std::string AASTOperator::value(int baseIndent) const {
         unaryOperator(stream, _operator, values[0]);
     }
     
+    else if (isComparison(_operator)) {
+        comparison(stream, _operator, values, _parameters);
+    }
+    
     else {
         binaryOperator(stream, _operator, values);
     }
@@ -368,40 +869,6 @@ std::string AASTOperator::value(int baseIndent) const {
     
 }
 
-void print(std::stringstream & stream, const std::vector<parameter> & values, const int indentLevel) {
-    
-    size_t c = 0;
-    
-    for (auto & p : values) {
-        
-        /* First value is indented automatically, others need to be indented manually */
-        if (c) {
-            stream << indent(indentLevel);
-        }
-        
-        if (p.type == syntax::pointerForType("char")) {
-            stream << "fputs(" + p.value + ", stdout)";
-        } else if (p.type == "char" or p.type == "uchar") {
-            stream << "putchar(" + p.value + ")";
-        } else if (p.type == "int") {
-            stream << "printf(\"%lld\", " + p.value + ")";
-        } else if (p.type == "uint") {
-            stream << "printf(\"%ull\", " + p.value + ")";
-        } else if (p.type == "num") {
-            stream << "printf(\"%f\", " + p.value + ")";
-        }
-        
-        ++c;
-        
-        if (c != values.size()) {
-            stream << ";\n";
-        }
-        
-    }
-    
-    
-}
-
 /* Inline C requires escaped escape sequences to use escape sequences in inline C  */
 /* because inline C is written as string literals                                  */
 /* Remove one level of escaping to allow usage of escape sequences inside inline C */
@@ -460,7 +927,7 @@ void inlineC(std::stringstream & stream, const std::vector<parameter> & values,
 void unaryOperator(std::stringstream & stream, const std::string & op, const parameter & parameter) {
     
     if (op == "-") {
-        stream << "((" << parameter.value << ") * (-1))";
+        stream << "(-(" << parameter.value << "))";
     }
     else if (op == "&") {
         
@@ -480,6 +947,11 @@ void unaryOperator(std::stringstream & stream, const std::string & op, const par
         }
         
     }
+    
+    /* Size of a type, type names are stored as values of their own type */
+    else if (op == "sizeof" and parameter.value == parameter.type) {
+        stream << op << "( " << translateType(parameter.type) << " )";
+    }
 
     else {
         stream << op << "( " << parameter.value << " )";
@@ -491,7 +963,14 @@ void _new(std::stringstream & stream, const std::vector<parameter> & values, con
     
     std::string type = translateType(values.front().value);
     //stream << "((" + parameter.value +  "*)malloc(sizeof(" + parameter.value + ")))";
-    stream << "(" << syntax::memoryAlloc << "(sizeof(" + type + "), ";
+    
+    /* Over-aligned objects are passed their alignment as the second value */
+    if (values.size() == 3) {
+        stream << "(" << syntax::alignedMemoryAlloc << "(sizeof(" + type + "), " << values[1].value << ", ";
+    } else {
+        stream << "(" << syntax::memoryAlloc << "(sizeof(" + type + "), ";
+    }
+    
     stream << values.back().value + "));";
     
 }
@@ -521,17 +1000,74 @@ void fmodOperator(std::stringstream & stream,
     
 }
 
+bool isComparison(const std::string & op) {
+    
+    return op == "<" or op == ">" or op == "<=" or op == ">=" or op == "==" or op == "!=";
+    
+}
+
+/* Checks if node can be evaluated more than once without side effects or additional cost */
+bool isSimpleOperand(AASTNode * node) {
+    
+    while (node->nodeType() == AASTNodeType::Cast) {
+        node = ((AASTCast *)node)->getValue();
+    }
+    
+    return node->nodeType() == AASTNodeType::Value;
+    
+}
+
+/* Chained comparisons use operands in the middle twice, eg. (< a b c) -> a < b && b < c         */
+/* Operands other than variables and literals are stored in temporaries declared inside a GNU   */
+/* statement expression, the temporary is assigned where the operand is first used, so operands */
+/* are still evaluated only if the previous comparison holds                                    */
+/* (< a (f) c) -> ({ int_type _cmp__1; a < (_cmp__1 = (f())) && _cmp__1 < c; })                */
 void comparison(std::stringstream & stream,
                 const std::string & op,
-                const std::vector<parameter> & parameters) {
+                const std::vector<parameter> & parameters,
+                const std::vector<AASTNode *> & nodes) {
+    
+    std::vector<std::string> temporaries(parameters.size());
+    
+    for (size_t i = 1; i < parameters.size() - 1; ++i) {
+        if (not isSimpleOperand(nodes[i])) {
+            temporaries[i] = "_cmp__" + std::to_string(i);
+        }
+    }
+    
+    const bool hoist = std::any_of(temporaries.begin(), temporaries.end(), [](const std::string & t) {
+        return t != "";
+    });
+    
+    if (hoist) {
+        
+        stream << "({ ";
+        
+        for (size_t i = 0; i < temporaries.size(); ++i) {
+            if (temporaries[i] != "") {
+                stream << translateType(parameters[i].type) << " " << temporaries[i] << "; ";
+            }
+        }
+        
+    }
     
     for (size_t i = 1; i < parameters.size(); ++i) {
         
-        stream << parameters[i - 1].value << " " << op << " " <<
-                  parameters[i].value << ((i < parameters.size() - 1) ? " && " : "");
+        const std::string & left = temporaries[i - 1] != "" ? temporaries[i - 1] : parameters[i - 1].value;
+        std::string right = parameters[i].value;
+        
+        if (temporaries[i] != "") {
+            right = "(" + temporaries[i] + " = (" + right + "))";
+        }
+        
+        stream << left << " " << op << " " << right << ((i < parameters.size() - 1) ? " && " : "");
         
     }
     
+    if (hoist) {
+        stream << "; })";
+    }
+    
 }
 
 void set(std::stringstream & stream,
@@ -549,10 +1085,6 @@ void binaryOperator(std::stringstream & stream,
         return fmodOperator(stream, parameters);
     }
     
-    if (op == "<" or op == ">" or op == "<=" or op == ">=" or op == "==" or op == "!=") {
-        return comparison(stream, op, parameters);
-    }
-    
     if (op == "=") {
         return set(stream, parameters);
     }
@@ -573,7 +1105,7 @@ void binaryOperator(std::stringstream & stream,
     
 }
 
-AASTCast::AASTCast(const AASTNode * value, const std::string desiredType) :
+AASTCast::AASTCast(AASTNode * value, const std::string desiredType) :
                 _value(value),
                 _desiredType(desiredType),
                 AASTNode(AASTNodeType::Cast, desiredType) { }
@@ -582,6 +1114,10 @@ AASTCast::~AASTCast() {
     delete _value;
 }
 
+AASTNode *& AASTCast::getValue() {
+    return _value;
+}
+
 std::string AASTCast::value(int baseIndent) const {
     
     std::stringstream stream;
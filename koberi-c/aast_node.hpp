@@ -12,14 +12,20 @@
 #include <iostream>
 #include <sstream>
 #include <vector>
+#include <algorithm>
+#include <map>
 
 #include "syntax.hpp"
 #include "parameter.hpp"
 #include "vtable.hpp"
 #include "name_mangler.hpp"
+#include "options.hpp"
 
 #define INDENT "    " /* Use four spaces to indent */
 
+/* Translates type from Kobeři-C type to C type */
+std::string translateType(const std::string & type);
+
 /* Set of self-translating AnalyzedAST nodes     */
 /* Nodes recursively translate themselves into C */
 
@@ -68,7 +74,7 @@ public:
 /* A scope -> {} */
 class AASTScope : public AASTNode {
     
-    const std::vector<AASTNode *> _body;
+    std::vector<AASTNode *> _body;
     
 public:
     
@@ -76,22 +82,61 @@ public:
     ~AASTScope();
     std::string value(int baseIndent = 0) const;
     
+    /* Provides access to nodes so the scope can be modified by optimizer */
+    std::vector<AASTNode *> & getBody();
+    
 };
 
 /* Language constructs used for control flow -> while, dowhile, if/elif/else */
 class AASTConstruct : public AASTNode {
     
     const std::string _construct;
-    const AASTNode * _condition;
-    const AASTScope * _body;
+    AASTNode * _condition;
+    AASTScope * _body;
+    
+    /* Counted loops declare their induction variable and loop invariant bounds */
+    /* for (int_type i = 0, i__end = n; i < i__end; i += 1)                     */
+    std::vector<AASTDeclaration *> _initializers;
+    AASTNode * _increment = nullptr;
+    
+    /* Index of the counter of an instrumented if/elif condition, -1 if the branch isn't counted */
+    int _branchCounter = -1;
+    /* Outcome of the condition expected from a profile, 1 - likely, 0 - unlikely, -1 - unknown */
+    int _expected = -1;
+    
+    /* Loop hints emitted as pragmas, eg. :unroll 4 -> #pragma GCC unroll 4 */
+    Options _options;
+    
+    /* Reduction variables of parallel loops and their operators */
+    std::map<std::string, std::string> _reductions;
+    
+    /* Parallel loops declare their induction variable before the loop, so it can be listed as private */
+    /* { int_type i; #pragma omp parallel for private(i) reduction(+:sum) for (i = 0; ...) }          */
+    std::string parallelFor(int baseIndent) const;
     
 public:
     
-    AASTConstruct(const std::string & construct, const AASTNode * condition, const AASTScope * body);
+    AASTConstruct(const std::string & construct, AASTNode * condition, AASTScope * body);
+    AASTConstruct(const std::string & construct,
+                  AASTNode * condition,
+                  AASTScope * body,
+                  const std::vector<AASTDeclaration *> & initializers,
+                  AASTNode * increment);
     ~AASTConstruct();
     
     std::string value(int baseIndent = 0) const;
     
+    const std::string & getConstruct() const;
+    AASTNode *& getCondition();
+    AASTScope *& getBody();
+    std::vector<AASTDeclaration *> & getInitializers();
+    AASTNode *& getIncrement();
+    
+    void setBranchCounter(int index);
+    void setExpected(int expected);
+    void setOptions(const Options & options);
+    void setReductions(const std::map<std::string, std::string> & reductions);
+    
 };
 
 /* Function and member function definitions */
@@ -99,18 +144,70 @@ class AASTFunction : public AASTNode {
     
     const std::vector<AASTDeclaration> _parameters;
     const std::string _mangledName;
-    const AASTScope * _body;
+    AASTScope * _body;
+    
+    /* Only exported functions have external linkage, the rest is static */
+    const bool _isExported;
+    bool _isInline = false;
+    
+    /* Instrumented functions record calls and cycles under their Kobeři-C name, eg. Vector::add(num) */
+    std::string _profileName;
+    int _branchCount = 0;
+    
+    /* Hot and cold functions are marked using GCC attributes based on a profile */
+    bool _isHot = false;
+    bool _isCold = false;
+    
+    /* Functions which spawn tasks declare a task group, which is synced when the function returns */
+    bool _spawnsTasks = false;
+    
+    /* Async functions create a coroutine, it's body is translated to a resume function which continues */
+    /* after the suspension point the coroutine suspended at. Frame holds variables, which are saved    */
+    /* when the coroutine suspends, parameters and the returned value are stored in the frame as well    */
+    bool _isAsync = false;
+    std::vector<AASTDeclaration> _frame;
+    size_t _suspendPoints = 0;
+    
+    /* Declares profiling frame and task group at the beginning of function body */
+    std::string prologue(int baseIndent) const;
+    /* Translates async function to a resume function and a function which creates the coroutine */
+    std::string coroutine(int baseIndent) const;
     
 public:
     
     AASTFunction(const std::string & name,
                  const std::string & type,
                  const std::vector<AASTDeclaration> & parameters,
-                 const AASTScope * body);
+                 AASTScope * body,
+                 bool isExported = false);
     
     std::string value(int baseIndent = 0) const;
     std::string declaration() const;
     
+    const std::string & getName() const;
+    AASTScope * getBody();
+    
+    bool isExported() const;
+    bool isInline() const;
+    void setInline(bool isInline);
+    
+    /* Instrumented functions count calls, cycles and outcomes of branchCount if/elif conditions */
+    void setProfileName(const std::string & name, int branchCount);
+    bool isInstrumented() const;
+    
+    bool isHot() const;
+    bool isCold() const;
+    void setHot(bool isHot);
+    void setCold(bool isCold);
+    
+    bool spawnsTasks() const;
+    void setSpawnsTasks(bool spawnsTasks);
+    
+    bool isAsync() const;
+    void setCoroutine(const std::vector<AASTDeclaration> & frame, size_t suspendPoints);
+    /* Returns definition of the frame struct of an async function */
+    std::string frame() const;
+    
 };
 
 /* Class definitions */
@@ -120,6 +217,13 @@ class AASTClass : public AASTNode {
     const std::string _name;
     const VTable _vtable;
     
+    /* Classes which are never instantiated don't need a vtable */
+    bool _isInstantiated = true;
+    /* Struct-of-arrays container is only defined for classes stored in containers */
+    bool _hasSoa = false;
+    /* Alignment of over-aligned classes, 0 if class is naturally aligned */
+    size_t _alignment = 0;
+    
 public:
     
     AASTClass(const std::string & name, const std::vector<AASTDeclaration> & attributes, const VTable & vtable);
@@ -127,12 +231,21 @@ public:
     std::string value(int baseIndent = 0) const;
     std::string vtable() const;
     
+    bool isInstantiated() const;
+    void setInstantiated(bool instantiated);
+    
+    bool hasSoa() const;
+    void setSoa(bool hasSoa);
+    
+    size_t alignment() const;
+    void setAlignment(size_t alignment);
+    
 };
 
 /* Function calls */
 class AASTFuncall : public AASTNode {
     
-    const std::vector<AASTNode *> _parameters;
+    std::vector<AASTNode *> _parameters;
     const std::string _mangledName;
     
 public:
@@ -142,6 +255,9 @@ public:
     
     std::string value(int baseIndent = 0) const;
     
+    const std::string & getName() const;
+    std::vector<AASTNode *> & getParameters();
+    
 };
 
 /* Literals, variables or type names */
@@ -162,20 +278,42 @@ public:
 class AASTDeclaration : public AASTNode {
     
     const std::string _name;
-    const AASTNode * _value;
+    AASTNode * _value;
+    
+    /* Arrays are declared with a pointer type, length is nullptr for other variables */
+    /* Length of heap arrays is stored in a separate variable                         */
+    AASTNode * _length = nullptr;
+    bool _onHeap = false;
+    
+    type_qualifiers _qualifiers;
     
 public:
     
-    AASTDeclaration(const std::string & name, const std::string & type, const AASTNode * value);
+    AASTDeclaration(const std::string & name, const std::string & type, AASTNode * value);
+    AASTDeclaration(const std::string & name,
+                    const std::string & type,
+                    AASTNode * value,
+                    const type_qualifiers & qualifiers);
+    AASTDeclaration(const std::string & name,
+                    const std::string & type,
+                    AASTNode * value,
+                    AASTNode * length,
+                    bool onHeap);
     ~AASTDeclaration();
     std::string value(int baseIndent = 0) const;
     
+    const std::string & getName() const;
+    /* Value the variable is initialized with, nullptr if variable isn't initialized */
+    AASTNode *& getValue();
+    /* Length of an array, nullptr if variable isn't an array */
+    AASTNode *& getLength();
+    
 };
 
 /* Operator calls */
 class AASTOperator : public AASTNode {
   
-    const std::vector<AASTNode *> _parameters;
+    std::vector<AASTNode *> _parameters;
     const std::string _operator;
     
 public:
@@ -185,22 +323,25 @@ public:
     
     std::string value(int baseIndent = 0) const;
     const std::string & getOperator() const;
+    std::vector<AASTNode *> & getParameters();
     
 };
 
 /* Type casts */
 class AASTCast : public AASTNode {
     
-    const AASTNode * _value;
+    AASTNode * _value;
     const std::string _desiredType;
     
 public:
     
-    AASTCast(const AASTNode * value, const std::string desiredType);
+    AASTCast(AASTNode * value, const std::string desiredType);
     ~AASTCast();
     
     std::string value(int baseIndent = 0) const;
     
+    AASTNode *& getValue();
+    
 };
 
 #endif /* aast_node_hpp */
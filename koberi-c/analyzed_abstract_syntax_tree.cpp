@@ -8,6 +8,8 @@
 
 #include "analyzed_abstract_syntax_tree.hpp"
 
+#include <algorithm>
+
 AnalyzedAbstractSyntaxTree::~AnalyzedAbstractSyntaxTree() {
     
     for (AASTClass * c : _classes) {
@@ -44,6 +46,18 @@ void AnalyzedAbstractSyntaxTree::emplaceFunction(AASTFunction * function) {
     _functions.emplace_back(function);
 }
 
+void AnalyzedAbstractSyntaxTree::emplaceSpawnedFunction(const spawned_function & function) {
+    
+    for (const spawned_function & f : _spawnedFunctions) {
+        if (f.name == function.name) {
+            return;
+        }
+    }
+    
+    _spawnedFunctions.emplace_back(function);
+    
+}
+
 const std::vector<AASTClass *> & AnalyzedAbstractSyntaxTree::getClasses() {
     return _classes;
 }
@@ -56,3 +70,44 @@ const std::vector<AASTFunction *> & AnalyzedAbstractSyntaxTree::getFunctions() {
     return _functions;
 }
 
+const std::vector<spawned_function> & AnalyzedAbstractSyntaxTree::getSpawnedFunctions() {
+    return _spawnedFunctions;
+}
+
+bool AnalyzedAbstractSyntaxTree::spawnsTasks() {
+    
+    for (AASTFunction * f : _functions) {
+        if (f->spawnsTasks()) {
+            return true;
+        }
+    }
+    
+    return false;
+    
+}
+
+bool AnalyzedAbstractSyntaxTree::usesCoroutines() {
+    
+    for (AASTFunction * f : _functions) {
+        if (f->isAsync()) {
+            return true;
+        }
+    }
+    
+    return false;
+    
+}
+
+void AnalyzedAbstractSyntaxTree::removeClass(AASTClass * c) {
+    
+    _classes.erase(std::remove(_classes.begin(), _classes.end(), c), _classes.end());
+    delete c;
+    
+}
+
+void AnalyzedAbstractSyntaxTree::removeFunction(AASTFunction * function) {
+    
+    _functions.erase(std::remove(_functions.begin(), _functions.end(), function), _functions.end());
+    delete function;
+    
+}
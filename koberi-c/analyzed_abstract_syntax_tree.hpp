@@ -13,6 +13,15 @@
 
 #include "aast_node.hpp"
 
+/* Function called by spawn, a task which runs the function is generated for each spawned function */
+struct spawned_function {
+    
+    std::string name;
+    std::string type;
+    std::vector<std::string> parameters;
+    
+};
+
 /* AnalyzedAbstractSyntaxTree class is a class which holds already analyzed nodes   */
 /* Function names are mangled, types inferred etc.                                  */
 /* AnalyzedAST nodes are self-translating                                           */
@@ -28,6 +37,9 @@ class AnalyzedAbstractSyntaxTree {
     /* Holds function and member function declarations */
     std::vector<AASTFunction *> _functions;
     
+    /* Holds functions called by spawn */
+    std::vector<spawned_function> _spawnedFunctions;
+    
     /* Holds C libraries which should be imported using #include directive */
     std::vector<std::string> * _cLibs;
     
@@ -40,11 +52,23 @@ public:
     void emplaceClass(AASTClass * c);
     void emplaceGlobalDeclaration(AASTDeclaration * declaration);
     void emplaceFunction(AASTFunction * function);
+    /* Functions spawned from multiple places are only stored once */
+    void emplaceSpawnedFunction(const spawned_function & function);
     
     /* Methods used to access AnalyzedAST nodes */
     const std::vector<AASTClass *> & getClasses();
     const std::vector<AASTDeclaration *> & getDeclarations();
     const std::vector<AASTFunction *> & getFunctions();
+    const std::vector<spawned_function> & getSpawnedFunctions();
+    
+    /* Checks if any function spawns tasks or waits for them, the task scheduler is only needed then */
+    bool spawnsTasks();
+    /* Checks if any function is async, coroutine runtime is only needed then */
+    bool usesCoroutines();
+    
+    /* Methods used to remove unused nodes, removed nodes are deleted */
+    void removeClass(AASTClass * c);
+    void removeFunction(AASTFunction * function);
     
     ~AnalyzedAbstractSyntaxTree();
     
@@ -8,7 +8,10 @@
 
 #include "analyzer.hpp"
 
-Analyzer::Analyzer(TraversableAbstractSyntaxTree & ast, AnalyzedAbstractSyntaxTree & aast) : _ast(ast), _aast(aast) {
+Analyzer::Analyzer(TraversableAbstractSyntaxTree & ast, AnalyzedAbstractSyntaxTree & aast) : _ast(ast),
+                                                                                           _aast(aast),
+                                                                                           _escapeAnalysis(ast),
+                                                                                           _layout(ast) {
     
 }
 
@@ -48,18 +51,39 @@ void Analyzer::analyzeClasses() {
 
         std::vector<AASTDeclaration> attributes;
         
-        for (const auto & attr : cls.attributes) {
+        const bool reorder = expr::isReorderAttributes() or cls.options.count("reorder");
+        const size_t alignment = cls.options.count("align") ? std::stoull(cls.options.at("align")) : 0;
+        
+        if (alignment and alignment < _layout.typeAlignment(syntax::pointerForType(cls.className))) {
+            throw invalid_declaration("Alignment of class " + cls.className + " must be at least the alignment of it's vtable pointer");
+        }
+        
+        if (cls.options.count("pool") and _ast.isOveraligned(cls.className)) {
+            throw invalid_declaration("Class " + cls.className + " can't be pooled, pools don't respect alignment set by :align");
+        }
+        
+        for (const auto & attr : _layout.arrange(cls.className, cls.superClass, cls.attributes, reorder, alignment)) {
             
             checkIdIsValid(attr.name);
-            attributes.emplace_back(AASTDeclaration(attr.name, attr.type, nullptr));
+            checkAlignment(attr.name, attr.type, attr.qualifiers);
+            attributes.emplace_back(AASTDeclaration(attr.name, attr.type, nullptr, attr.qualifiers));
             
         }
         
         AASTClass * _class = new AASTClass(cls.className, attributes, cls.vtable);
+        
+        if (_ast.isOveraligned(cls.className)) {
+            _class->setAlignment(_layout.typeAlignment(cls.className));
+        }
+        
         _aast.emplaceClass(_class);
         
     }
     
+    if (expr::isLayoutReport()) {
+        _layout.report(std::cout);
+    }
+    
 }
 
 void Analyzer::analyzeGlobalVars() {
@@ -74,8 +98,17 @@ void Analyzer::analyzeGlobalVars() {
             
             ASTDeclaration * decl = (ASTDeclaration*)node;
             checkIdIsValid(decl->name);
+            useSoa(decl->type);
+            
+            checkQualifiers(decl->name, decl->type, decl->qualifiers);
+            checkAlignment(decl->name, decl->type, decl->qualifiers);
+            
+            /* Global variables can't be initialized, so constants would always be zero */
+            if (decl->qualifiers.isConst) {
+                throw invalid_declaration("Global variable " + decl->name + " can't be const");
+            }
             
-            AASTDeclaration * declaration = new AASTDeclaration(decl->name, decl->type, nullptr);
+            AASTDeclaration * declaration = new AASTDeclaration(decl->name, decl->type, nullptr, decl->qualifiers);
             _aast.emplaceGlobalDeclaration(declaration);
             
         }
@@ -148,6 +181,17 @@ void Analyzer::analyzeFunction(ASTFunction & function) {
     _functionType = function.type;
     _declarations = std::vector<ASTDeclaration *>();
     
+    _isAsync = function.options.count("async");
+    _coroutineVariables.clear();
+    _coroutineFrame.clear();
+    _frameFields.clear();
+    _suspendPoints = 0;
+    _addressedVariables.clear();
+    _suspendedVariables.clear();
+    
+    /* Stack allocated objects wouldn't survive suspension of a coroutine */
+    _stackAllocations = _isAsync ? stack_allocations() : _escapeAnalysis.analyze(function);
+    
     const std::vector<parameter> & params = function.parameters;
     
     if (expr::isVerbose()) {
@@ -166,6 +210,10 @@ void Analyzer::analyzeFunction(ASTFunction & function) {
         name = NameMangler::premangleMethodName(name, function.className);
     }
     
+    _mangledName = name;
+    _branchCount = 0;
+    _spawnsTasks = false;
+    
     std::vector<AASTDeclaration> parameters;
     
     /* If function is a member function, pass pointer to self as first parameter */
@@ -174,18 +222,62 @@ void Analyzer::analyzeFunction(ASTFunction & function) {
     }
     
     for (size_t i = 0; i < params.size(); ++i) {
-        parameters.emplace_back(AASTDeclaration(params[i].name, params[i].type, nullptr));
+        useSoa(params[i].type);
+        checkQualifiers(params[i].name, params[i].type, params[i].qualifiers);
+        
+        /* Parameters are copies, which are never shared with other threads */
+        if (params[i].qualifiers.isAtomic or params[i].qualifiers.isThreadLocal) {
+            throw invalid_declaration("Parameter " + params[i].name + " can't be atomic or thread_local");
+        }
+        
+        parameters.emplace_back(AASTDeclaration(params[i].name, params[i].type, nullptr, params[i].qualifiers));
+        
+        /* Parameters are stored in the frame when the coroutine is created */
+        declareCoroutineVariable(params[i], (ASTScope *)&function);
+        _frameFields[params[i].name + " " + params[i].type] = params[i].name;
     }
     
     AASTFunction * analyzedFunction = new AASTFunction(name,
                                                        function.type,
                                                        parameters,
-                                                       analyzeScope(function.childNodes));
+                                                       analyzeScope(function.childNodes),
+                                                       function.options.count("export"));
+    
+    /* Vtable initializers and global variable initialization are generated, they aren't profiled */
+    if (function.name != syntax::vtableInit and function.name != "_globalVarInit") {
+        
+        if (expr::isInstrument()) {
+            analyzedFunction->setProfileName(profileName(function), _branchCount);
+        }
+        
+        analyzedFunction->setHot(_profile.isHot(name));
+        analyzedFunction->setCold(_profile.isCold(name));
+    }
+    
+    analyzedFunction->setSpawnsTasks(_spawnsTasks);
+    
+    if (_isAsync) {
+        analyzedFunction->setCoroutine(_coroutineFrame, _suspendPoints);
+    }
     
     _aast.emplaceFunction(analyzedFunction);
     
 }
 
+std::string Analyzer::profileName(const ASTFunction & function) {
+    
+    std::string name = function.className == "" ? function.name : function.className + "::" + function.name;
+    
+    name += "(";
+    
+    for (size_t i = 0; i < function.parameters.size(); ++i) {
+        name += (i ? ", " : "") + function.parameters[i].type;
+    }
+    
+    return name + ")";
+    
+}
+
 AASTScope * Analyzer::analyzeScope(std::vector<ASTNode *> scopeNodes) {
     
     std::vector<AASTNode *> body;
@@ -199,7 +291,14 @@ AASTScope * Analyzer::analyzeScope(std::vector<ASTNode *> scopeNodes) {
             _declarations.emplace_back((ASTDeclaration *)node);
         }
         
-        body.emplace_back(analyzeFunctionNode(node));
+        _awaitCall = statementAwait(node);
+        AASTNode * statement = analyzeFunctionNode(node);
+        
+        /* Coroutine suspends before the statement using the awaited value */
+        body.insert(body.end(), _awaits.begin(), _awaits.end());
+        _awaits.clear();
+        
+        body.emplace_back(statement);
     }
 
     /* After translating all body nodes, call destructors on scoped objects */
@@ -280,14 +379,67 @@ AASTNode * Analyzer::analyzeFunCall(ASTFunCall & funcall) {
             ASTVariable & v = *(ASTVariable*)funcall.parameters[0];
             
             if (_ast.isDataType(v.name)) {
+                
+                if (expr::isVectorType(v.name)) {
+                    _ast.setUsesVectors();
+                }
+                
                 return new AASTOperator("sizeof", "int", { new AASTValue(v.name, v.name) });
             }
+            
+            ASTDeclaration * array = getArray(v.name, v.parentScope);
+            
+            /* Stack arrays are C arrays, so sizeof returns the size of the whole array */
+            if (array != nullptr and not array->onHeap) {
+                return new AASTOperator("sizeof", "int", { new AASTValue(v.name, array->type) });
+            }
+            
+            /* Size of a heap array is the size of it's elements times it's length */
+            if (array != nullptr) {
+                
+                std::string elementType = array->type;
+                elementType.pop_back();
+                
+                AASTOperator * elementSize = new AASTOperator("sizeof", "int", {
+                    new AASTValue(elementType, elementType)
+                });
+                AASTValue * length = new AASTValue(NameMangler::arrayLengthName(v.name), "int");
+                
+                return new AASTOperator("*", "int", { elementSize, length });
+                
+            }
         }
     }
     
+    /* vec_load and vec_splat receive a vector type as their first parameter */
+    if (expr::isVectorBuiltin(name) and funcall.object == nullptr) {
+        return (AASTNode *)vectorBuiltin(funcall);
+    }
+    
+    /* Atomic variable is accessed through it's address, plain access is rejected */
+    if (expr::isAtomicBuiltin(name) and funcall.object == nullptr) {
+        return (AASTNode *)atomicBuiltin(funcall);
+    }
+    
+    /* Spawned call is analyzed as a whole, it's parameters are passed to the task */
+    if (name == "spawn" and funcall.object == nullptr) {
+        return (AASTNode *)spawn(funcall);
+    }
+    if (name == "sync" and funcall.object == nullptr) {
+        return (AASTNode *)sync(funcall);
+    }
+    
+    /* Awaited call creates a coroutine, which is resumed until it finishes */
+    if (name == "await" and funcall.object == nullptr) {
+        return await(funcall);
+    }
+    if (name == "yield" and funcall.object == nullptr) {
+        return (AASTNode *)yield(funcall);
+    }
+    
     if (name == "new" and funcall.parameters.size() == 1 and funcall.object == nullptr) {
         type = ((ASTVariable*)funcall.parameters[0])->name;
-        return (AASTNode *)newObject(type);
+        return newObject(type);
     }
     
     std::vector<AASTNode *> params;
@@ -302,17 +454,63 @@ AASTNode * Analyzer::analyzeFunCall(ASTFunCall & funcall) {
         }
     }
     
+    if (expr::isHintBuiltin(name) and funcall.object == nullptr) {
+        return hintBuiltin(name, params);
+    }
+    
+    /* (resume coroutine) returns 1 if the coroutine suspended and 0 if it finished, (done coroutine) checks */
+    /* if the coroutine finished                                                                           */
+    if ((name == "resume" or name == "done") and funcall.object == nullptr and params.size() == 1 and
+        params[0]->type() == syntax::coroutine) {
+        
+        return new AASTFuncall(name == "resume" ? syntax::coroutineResume : syntax::coroutineDone, "int", params);
+    }
+    
     if (name == "delete" and funcall.object == nullptr and params.size() == 1) {
-        return (AASTNode *)deleteObject(params[0]);
+        
+        ASTDeclaration * array = nullptr;
+        
+        if (funcall.parameters[0]->nodeType == NodeType::Variable) {
+            array = getArray(((ASTVariable*)funcall.parameters[0])->name, funcall.parameters[0]->parentScope);
+        }
+        
+        if (array != nullptr and not array->onHeap) {
+            throw invalid_parameter("Stack array " + array->name + " can't be deleted.");
+        }
+        
+        /* Frames start with the coroutine header, so the coroutine points to the whole frame */
+        if (params[0]->type() == syntax::coroutine) {
+            return new AASTFuncall("free", "void", params);
+        }
+        
+        std::string deletedType = params[0]->type();
+        if (syntax::isPointerType(deletedType)) {
+            deletedType.pop_back();
+        }
+        
+        if (_ast.isSoa(deletedType)) {
+            return (AASTNode *)deleteSoa(params[0]);
+        }
+        
+        return (AASTNode *)deleteObject(params[0], _stackAllocations.deletes.count(&funcall), array != nullptr);
+    }
+    if (name == "at" and funcall.object == nullptr) {
+        return (AASTNode *)index(params);
     }
     if (name == "return" and funcall.object == nullptr) {
+        checkParallelJump(name);
         return (AASTNode *)analyzeReturn(params);
     }
     if (expr::isOperator(name) and funcall.object == nullptr) {
+        
+        if (name == "&" and params.size() == 1) {
+            addressOfCoroutineVariable(params[0]);
+        }
+        
         return (AASTNode *)analyzeOperator(name, params);
     }
     if (name == "print" and funcall.object == nullptr) {
-        return (AASTNode *)analyzePrint(params);
+        return analyzePrint(params);
     }
     if (name == "_c" and funcall.object == nullptr) {
         return (AASTNode *)inlineC(params, funcall);
@@ -347,6 +545,8 @@ AASTNode * Analyzer::analyzeFunCall(ASTFunCall & funcall) {
         
         type = m.type;
         
+        checkConstArguments(funcall.function, NameMangler::premangleMethodName(name, m.className), params);
+        
         /* Virtual call if method is called on a pointer */
         if (syntax::isPointerType(object.type())) {
             params.insert(params.begin(), op);
@@ -362,6 +562,12 @@ AASTNode * Analyzer::analyzeFunCall(ASTFunCall & funcall) {
         
     } else {
         type = _ast.getFunctionReturnType(name);
+        checkConstArguments(funcall.function, name, params);
+    }
+    
+    /* Calling an async function only creates a coroutine */
+    if (_ast.isAsyncFunction(name)) {
+        type = syntax::coroutine;
     }
     
     if (funcall.object != nullptr) {
@@ -411,6 +617,13 @@ AASTNode * Analyzer::getFuncallParameter(ASTNode * node) {
         /* Get var name and type */
         parameter var = getVariable(variable);
         
+        /* Plain reads and writes of atomic variables could tear or be reordered, also their address */
+        /* can't be taken, because pointers don't carry the qualifier                                */
+        if (getQualifiers(var.name, variable.parentScope).isAtomic) {
+            throw type_mismatch("Error: Atomic variable " + var.name + " can only be accessed using atomic operations "
+                                "in function " + currentFunction());
+        }
+        
         AASTNode * node = (AASTNode *) new AASTValue(var.value, var.type);
         
         return node;
@@ -451,28 +664,134 @@ AASTNode * Analyzer::getFuncallParameter(ASTNode * node) {
 
 // AASTOperator * Analyzer::size_of(const std::string & val) {}
 
-AASTOperator * Analyzer::analyzePrint(std::vector<AASTNode *> & parameters) {
+AASTNode * Analyzer::analyzePrint(std::vector<AASTNode *> & parameters) {
     
     
     /* If no parameters are passed print \n */
     if (not parameters.size()) {
-        parameters.emplace_back((AASTNode *)new AASTValue("\"\n\"", syntax::pointerForType("char")));
+        parameters.emplace_back((AASTNode *)new AASTValue("\"\\n\"", syntax::pointerForType("char")));
     }
     
-    const std::vector<std::string> valid_types = { "char", "uchar", "int", "uint", "num",
-                                                    syntax::intType, syntax::uintType, syntax::floatType };
+    const std::vector<std::string> valid_types = { syntax::intType, syntax::uintType, syntax::floatType };
     
     for (AASTNode * node : parameters) {
         
         const std::string & type = node->type();
         
-        if (not syntax::isPointerType(type) and not contains(valid_types, type)) {
+        if (not syntax::isPointerType(type) and not expr::isNumericalType(type) and not contains(valid_types, type)) {
             throw invalid_parameter(currentFunction(), "(print)", node->value());
         }
         
     }
     
-    return new AASTOperator("print", "", parameters);
+    /* Format is made of adjacent string literals, which are concatenated by the C compiler   */
+    /* Keeping literals separate preserves escape sequences, eg. "\x4" "2" isn't "\x42" */
+    std::vector<std::string> format;
+    std::vector<std::string> text;
+    std::vector<AASTNode *> arguments;
+    
+    std::vector<AASTNode *> calls;
+    
+    auto join = [](const std::vector<std::string> & literals) -> std::string {
+        
+        std::string joined;
+        
+        for (const std::string & literal : literals) {
+            joined += (joined.empty() ? "" : " ") + literal;
+        }
+        
+        return joined;
+        
+    };
+    
+    /* Prints parameters collected so far with a single call */
+    auto flush = [&]() {
+        
+        if (text.empty() and arguments.empty()) {
+            return;
+        }
+        
+        /* Only string literals are printed, no formatting is needed */
+        if (arguments.empty()) {
+            
+            std::vector<AASTNode *> params = {
+                new AASTValue(join(text), syntax::pointerForType("char")),
+                new AASTValue("stdout", "FILE*")
+            };
+            
+            calls.emplace_back(new AASTFuncall("fputs", "", params));
+            
+        } else {
+            
+            arguments.insert(arguments.begin(), new AASTValue(join(format), syntax::pointerForType("char")));
+            calls.emplace_back(new AASTFuncall("printf", "", arguments));
+            
+        }
+        
+        format.clear();
+        text.clear();
+        arguments.clear();
+        
+    };
+    
+    for (AASTNode * node : parameters) {
+        
+        const std::string type = node->type();
+        const std::string value = node->value();
+        
+        if (type == syntax::pointerForType("char") and value.front() == '"') {
+            
+            std::string escaped;
+            for (char c : value) {
+                escaped += c;
+                if (c == '%') {
+                    escaped += '%';
+                }
+            }
+            
+            format.emplace_back(escaped);
+            text.emplace_back(value);
+            delete node;
+            continue;
+            
+        }
+        
+        /* C doesn't specify the order in which arguments are evaluated, parameters with side effects, eg. calls, */
+        /* start a new printf, so everything before them is printed first and they're evaluated left to right    */
+        /* Pure expressions, eg. (+ x 1), are formatted by the same printf as variables                         */
+        if (expr::hasSideEffects(node)) {
+            flush();
+        }
+        
+        if (type == syntax::pointerForType("char")) {
+            format.emplace_back("\"%s\"");
+        } else if (syntax::isPointerType(type)) {
+            format.emplace_back("\"%p\"");
+            node = new AASTCast(node, syntax::pointerForType("void"));
+        } else if (type == "char" or type == "uchar") {
+            format.emplace_back("\"%c\"");
+        } else if (expr::isSignedType(type) or type == syntax::intType) {
+            /* Literals and sized integers have to be cast to match the format */
+            format.emplace_back("\"%jd\"");
+            node = new AASTCast(node, "int");
+        } else if (expr::isUnsignedType(type) or type == syntax::uintType) {
+            format.emplace_back("\"%ju\"");
+            node = new AASTCast(node, "uint");
+        } else {
+            format.emplace_back("\"%f\"");
+        }
+        
+        arguments.emplace_back(node);
+        
+    }
+    
+    flush();
+    
+    if (calls.size() == 1) {
+        return calls.front();
+    }
+    
+    return new AASTScope(calls);
     
 }
 
@@ -541,6 +860,21 @@ AASTScope * Analyzer::analyzeReturn(std::vector<AASTNode *> & parameters) {
         }
     }
     
+    /* Coroutines store the value in their frame and finish */
+    if (_isAsync) {
+        
+        if (retval != nullptr) {
+            AASTValue * result = new AASTValue(syntax::coroutineFrameVariable + "->" + syntax::coroutineResult, _functionType);
+            calls.emplace_back((AASTNode *)new AASTOperator("=", "void", { result, retval }));
+        }
+        
+        calls.emplace_back((AASTNode *)new AASTValue(syntax::coroutineVariable + "->state = -1", "void"));
+        calls.emplace_back((AASTNode *)new AASTOperator("return", "void", { new AASTValue("0", "int") }));
+        
+        return new AASTScope(calls);
+        
+    }
+    
     if (retval != nullptr) {
         
         calls.emplace_back((AASTNode *)new AASTOperator("return", "void", { retval }));
@@ -551,7 +885,7 @@ AASTScope * Analyzer::analyzeReturn(std::vector<AASTNode *> & parameters) {
     return new AASTScope(calls);
 }
 
-AASTScope * Analyzer::deleteObject(AASTNode * object) {
+AASTScope * Analyzer::deleteObject(AASTNode * object, bool onStack, bool isArray) {
     
     
     AASTFuncall * destructor = nullptr;
@@ -565,7 +899,7 @@ AASTScope * Analyzer::deleteObject(AASTNode * object) {
     std::string type = object->type();
     type.pop_back();
     
-    if (_ast.isClass(type)) {
+    if (_ast.isClass(type) and not isArray) {
         
         if (_ast.hasDestructor(type)) {
             
@@ -574,10 +908,16 @@ AASTScope * Analyzer::deleteObject(AASTNode * object) {
         }
     }
 
-    AASTOperator * objectAddress =
-        new AASTOperator("&", syntax::pointerForType(type), std::vector<AASTNode *>( {object} ));
-    
-    free = new AASTFuncall("free", "void", std::vector<AASTNode *>( { objectAddress } ));
+    /* Stack objects are released automatically at the end of their scope */
+    if (not onStack) {
+        
+        AASTOperator * objectAddress =
+            new AASTOperator("&", syntax::pointerForType(type), std::vector<AASTNode *>( {object} ));
+        
+        const std::string deallocator = isArray ? "free" : getDeallocator(type);
+        
+        free = new AASTFuncall(deallocator, "void", std::vector<AASTNode *>( { objectAddress } ));
+    }
     
     if (object->nodeType() == AASTNodeType::Value) {
         AASTValue * null_ptr = new AASTValue("0", syntax::pointerForType("void"));
@@ -702,6 +1042,11 @@ void Analyzer::checkIsAssignable(AASTNode * value) {
         
         AASTOperator & op = *((AASTOperator *)value);
         
+        /* Array elements are assignable */
+        if (op.getOperator() == "[]") {
+            return;
+        }
+        
         if (op.getOperator() == "&") {
             
             try {
@@ -735,176 +1080,1664 @@ void Analyzer::checkIsAssignable(AASTNode * value) {
     
 }
 
-AASTFuncall * Analyzer::copyObject(AASTNode * lvalue, AASTNode * rvalue) {
+void Analyzer::checkIsWritable(AASTNode * value, bool throughPointer) {
     
-    AASTFuncall * fcall = nullptr;
+    /* Elements of arrays and vectors are written through the array/vector variable */
+    if (value->nodeType() == AASTNodeType::Operator and ((AASTOperator *)value)->getOperator() == "[]") {
+        
+        value = ((AASTOperator *)value)->getParameters()[0];
+        throughPointer = true;
+        
+    }
     
-    auto toPtr = [&](AASTNode * value) -> AASTNode* {
-        if (not syntax::isPointerType(value->type())) {
-            std::vector<AASTNode *> val = { value };
-            return analyzeOperator("&", val);
-        }
-        return value;
-    };
+    if (value->nodeType() != AASTNodeType::Value) {
+        return;
+    }
     
-    lvalue = toPtr(lvalue);
-    rvalue = toPtr(rvalue);
+    const std::string name = value->value();
     
-    std::string type = lvalue->type();
-    if (type.back() == syntax::pointerChar) {
-        type.pop_back();
+    if (not getQualifiers(name, _currentScope).isConst) {
+        return;
     }
     
-    std::vector<AASTNode *> size_of = { new AASTValue(type, type) };
-    
-    fcall = new AASTFuncall(syntax::copyObject, "void", { lvalue, rvalue, analyzeOperator("size_of", size_of) });
+    if (syntax::isPointerType(value->type()) and not throughPointer) {
+        return;
+    }
     
-    return fcall;
+    throw type_mismatch("Error: Can't modify constant " + name + " in function " + currentFunction());
     
 }
 
-AASTOperator * Analyzer::analyzeOperator(const std::string & op, std::vector<AASTNode *> & params) {
+bool Analyzer::pointsToConst(AASTNode * value) {
     
-    if (params.size() == 2 and op == "set") {
-        
-        checkIsAssignable(params.front());
-        
-        /* Check if references are being assigned. If not, copy objects */
-        /* If yes, just assign references                               */
-        
-        const bool lIsClass = _ast.isClass(params.front()->type());
-        const bool rIsClass = _ast.isClass(params.back()->type());
-        const bool lIsPtr = syntax::isPointerType(params.front()->type());
-        bool rIsAmp = false;
-        if (params.back()->nodeType() == AASTNodeType::Operator) {
-            AASTOperator & op = *((AASTOperator*)params.back());
-            rIsAmp = op.getOperator() == "&";
-        }
-        const bool rIsPtr = rIsAmp;
-        
-        if (lIsClass and rIsClass and not (lIsPtr and rIsPtr)) {
-            
-            return (AASTOperator*)copyObject(params.front(), params.back());
-        
-        }
+    while (value->nodeType() == AASTNodeType::Cast) {
+        value = ((AASTCast *)value)->getValue();
     }
     
-    const bool isParamless = expr::isParameterlessOperator(op);
-    const bool isUnary     = expr::isUnaryOperator(op);
-    const bool isBinary    = expr::isBinaryOperator(op);
+    if (value->nodeType() == AASTNodeType::Value) {
+        return syntax::isPointerType(value->type()) and getQualifiers(value->value(), _currentScope).isConst;
+    }
     
-    if (isParamless) {
-        
-        if (params.size() and not (isUnary or isBinary)) {
-            throw invalid_call(op, currentFunction(), " Too many parameters");
-        }
-        
-        if (not params.size()) {
-            return expr::parameterless_operator(op);
-        }
-        
+    if (value->nodeType() != AASTNodeType::Operator) {
+        return false;
     }
     
-    if (isUnary) {
+    AASTOperator * op = (AASTOperator *)value;
+    std::vector<AASTNode *> & params = op->getParameters();
+    
+    /* Address of a constant, of an element of a const pointer or of a value a const pointer points to */
+    if (op->getOperator() == "&") {
         
-        if (not params.size()) {
-            throw invalid_call(op, currentFunction(), " Too few parameters");
-        } else if (params.size() > 1 and not isBinary) {
-            throw invalid_call(op, currentFunction(), " Too many parameters");
-        }
+        AASTNode * referenced = params[0];
         
-        if (params.size() == 1) {
-            return expr::unaryOperator(params[0], op);
+        if (referenced->nodeType() == AASTNodeType::Operator and
+            (((AASTOperator *)referenced)->getOperator() == "[]" or ((AASTOperator *)referenced)->getOperator() == "*")) {
+            referenced = ((AASTOperator *)referenced)->getParameters()[0];
         }
         
+        return referenced->nodeType() == AASTNodeType::Value and
+               getQualifiers(referenced->value(), _currentScope).isConst;
     }
     
-    if (isBinary) {
-        
-        if (params.size() < 2) {
-            throw invalid_call(op, currentFunction(), " Too few parameters");
-        }
-        
-        return expr::binaryOperator(params, op);
-        
+    /* Pointer arithmetic keeps pointing to the same data */
+    if ((op->getOperator() == "+" or op->getOperator() == "-") and syntax::isPointerType(op->type())) {
+        return std::any_of(params.begin(), params.end(), [&](AASTNode * param) { return pointsToConst(param); });
     }
     
-    throw invalid_operator(op);
+    return false;
     
 }
 
-AASTConstruct * Analyzer::analyzeConstruct(ASTConstruct & construct) {
-    
-    static const std::array<NodeType, 4> allowed_node_types = {
-        NodeType::Variable, NodeType::Literal, NodeType::MemberAccess, NodeType::FunCall
-    };
+void Analyzer::checkConstIsKept(AASTNode * value, bool targetIsConst, const std::string & description) {
     
-    if (not contains(allowed_node_types, construct.condition->nodeType)) {
-        
-        throw invalid_syntax("Error: Invalid condition in construct " +
-                             construct.construct + " in function " + currentFunction());
+    if (targetIsConst or not pointsToConst(value)) {
+        return;
     }
     
-    AASTNode * condition = nullptr;
-    
-    /* Analyze condition if construct isn't else           */
-    /* Else doesn't have a condition, everything else does */
-    if (construct.construct != "else") {
+    throw type_mismatch("Error: Can't assign pointer to constant " + value->value() + " to non-const " + description +
+                        " in function " + currentFunction());
     
-        condition = getFuncallParameter(construct.condition);
-        
-        if (not (expr::isNumericalType(condition->type()) or syntax::isPointerType(condition->type()))) {
-            throw type_mismatch("Error: Conditions must be of numerical or pointer type. Construct: " +
-                                construct.construct + " Function: " + currentFunction());
-        }
-        
-    }
+}
+
+void Analyzer::checkConstArguments(const std::string & function,
+                                   const std::string & mangledName,
+                                   const std::vector<AASTNode *> & params) {
     
-    /* If construct is elif, expand to else if */
-    const std::string cstruct = construct.construct == "elif" ? "else if" : construct.construct;
+    const std::vector<type_qualifiers> & qualifiers = _ast.getParameterQualifiers(mangledName);
     
-    return new AASTConstruct(cstruct, condition, analyzeScope(construct.childNodes));
+    for (size_t i = 0; i < qualifiers.size() and i < params.size(); ++i) {
+        checkConstIsKept(params[i], qualifiers[i].isConst,
+                         "parameter " + std::to_string(i + 1) + " of " + function);
+    }
     
 }
 
-/* If type is to be inferred, inferred type is also stored in ast. */
-AASTDeclaration * Analyzer::analyzeDeclaration(ASTDeclaration & declaration) {
+void Analyzer::checkParallelWrite(AASTNode * value, bool throughPointer) {
     
-    std::string decl;
+    /* Elements of arrays are written through the array variable */
+    if (value->nodeType() == AASTNodeType::Operator and ((AASTOperator *)value)->getOperator() == "[]") {
+        return;
+    }
     
-    checkIdIsValid(declaration.name);
+    if (value->nodeType() != AASTNodeType::Value or (syntax::isPointerType(value->type()) and throughPointer)) {
+        return;
+    }
+    
+    const std::string name = value->value();
+    const ASTConstruct * parallelLoop = nullptr;
+    
+    for (ASTScope * scope = _currentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->vars.count(name) and scope->vars.at(name) != "") {
+            break;
+        }
+        
+        if (scope->nodeType == NodeType::Construct and ((ASTConstruct *)scope)->construct == "pfor") {
+            
+            parallelLoop = (ASTConstruct *)scope;
+            
+            /* Reduction variables of inner loops must also be private or reductions of outer loops */
+            if (not parallelLoop->reductions.count(name)) {
+                break;
+            }
+            
+            parallelLoop = nullptr;
+        }
+        
+    }
+    
+    if (parallelLoop == nullptr) {
+        return;
+    }
+    
+    /* Values, which aren't variables, eg. attributes accessed through self, are left to the C compiler */
+    for (ASTScope * scope = parallelLoop->parentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->vars.count(name) and scope->vars.at(name) != "") {
+            throw invalid_syntax("Error: Shared variable " + name + " is written in a parallel loop in function " +
+                                 currentFunction() + ", declare it as a reduction. ");
+        }
+        
+    }
+    
+}
+
+void Analyzer::checkParallelJump(const std::string & jump) {
+    
+    if (jump != "return" and jump != "break") {
+        return;
+    }
+    
+    for (ASTScope * scope = _currentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->nodeType != NodeType::Construct) {
+            continue;
+        }
+        
+        const std::string & construct = ((ASTConstruct *)scope)->construct;
+        
+        if (construct == "pfor") {
+            throw invalid_syntax("Error: Can't " + jump + " out of a parallel loop in function " +
+                                 currentFunction());
+        }
+        
+        /* Break only leaves the innermost loop */
+        if (jump == "break" and (construct == "while" or construct == "dowhile" or construct == "for")) {
+            return;
+        }
+        
+    }
+    
+}
+
+void Analyzer::checkReductions(ASTConstruct & construct) {
+    
+    const std::string & inductionVariable = ((ASTFunCall *)construct.condition)->function;
+    
+    for (const auto & reduction : construct.reductions) {
+        
+        const std::string & name = reduction.first;
+        const std::string type = _ast.getVarType(name, construct.parentScope);
+        
+        if (name == inductionVariable or not expr::isNumericalType(type) or expr::isVectorType(type)) {
+            throw invalid_declaration("Invalid reduction variable " + name + " in function " + currentFunction());
+        }
+        
+        if (getQualifiers(name, construct.parentScope).isConst) {
+            throw type_mismatch("Error: Can't modify constant " + name + " in function " + currentFunction());
+        }
+        
+        if (getQualifiers(name, construct.parentScope).isAtomic) {
+            throw invalid_declaration("Atomic variable " + name + " can't be a reduction variable in function " +
+                                      currentFunction());
+        }
+        
+    }
+    
+}
+
+type_qualifiers Analyzer::getQualifiers(const std::string & name, ASTScope * scope) {
+    
+    /* Find the scope in which the variable is declared, inner declarations shadow outer ones */
+    for (; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->vars.count(name) and scope->vars.at(name) != "") {
+            return scope->qualifiers.count(name) ? scope->qualifiers.at(name) : type_qualifiers();
+        }
+        
+    }
+    
+    return type_qualifiers();
+    
+}
+
+void Analyzer::checkAlignment(const std::string & name, const std::string & type, const type_qualifiers & qualifiers) {
+    
+    /* C doesn't allow _Alignas to weaken the natural alignment of a type */
+    if (qualifiers.alignment and qualifiers.alignment < _layout.typeAlignment(type)) {
+        throw invalid_declaration("Alignment of " + name + " must be at least the natural alignment of type " + type);
+    }
+    
+}
+
+void Analyzer::checkQualifiers(const std::string & name, const std::string & type, const type_qualifiers & qualifiers) {
+    
+    if (qualifiers.isRestrict and not syntax::isPointerType(type)) {
+        throw invalid_declaration("Only pointers can be restrict, " + name + " is of type " + type);
+    }
+    
+    std::string valueType = type;
+    if (syntax::isPointerType(valueType)) {
+        valueType.pop_back();
+    }
+    
+    if (qualifiers.isAtomic and not (syntax::isPointerType(type) or
+                                     (expr::isNumericalType(type) and not expr::isVectorType(type)))) {
+        throw invalid_declaration("Only numerical and pointer variables can be atomic, " + name + " is of type " + type);
+    }
+    
+    if (qualifiers.isAtomic and (qualifiers.isConst or qualifiers.isRestrict)) {
+        throw invalid_declaration("Atomic variable " + name + " can't be const or restrict");
+    }
+    
+    if (qualifiers.isThreadLocal and qualifiers.isConst) {
+        throw invalid_declaration("Thread local variable " + name + " can't be const");
+    }
+    
+    /* Methods and copy functions take objects as non-const pointers */
+    if (qualifiers.isConst and not syntax::isPointerType(valueType) and _ast.isClass(valueType)) {
+        throw invalid_declaration("Objects can't be const, " + name + " is of type " + type);
+    }
+    
+}
+
+AASTFuncall * Analyzer::copyObject(AASTNode * lvalue, AASTNode * rvalue) {
+    
+    AASTFuncall * fcall = nullptr;
+    
+    auto toPtr = [&](AASTNode * value) -> AASTNode* {
+        if (not syntax::isPointerType(value->type())) {
+            std::vector<AASTNode *> val = { value };
+            return analyzeOperator("&", val);
+        }
+        return value;
+    };
+    
+    lvalue = toPtr(lvalue);
+    rvalue = toPtr(rvalue);
+    
+    std::string type = lvalue->type();
+    if (type.back() == syntax::pointerChar) {
+        type.pop_back();
+    }
+    
+    /* Only the part of the object which belongs to the assigned class is copied */
+    if (rvalue->type() != lvalue->type()) {
+        rvalue = new AASTCast(rvalue, lvalue->type());
+    }
+    
+    fcall = new AASTFuncall(NameMangler::copyFunctionName(type), "void", { lvalue, rvalue });
+    
+    return fcall;
+    
+}
+
+AASTOperator * Analyzer::analyzeOperator(const std::string & op, std::vector<AASTNode *> & params) {
+    
+    if (params.size() == 2 and op == "set") {
+        
+        checkIsAssignable(params.front());
+        checkIsWritable(params.front(), syntax::isPointerType(params.front()->type()) and
+                                        not syntax::isPointerType(params.back()->type()));
+        checkParallelWrite(params.front(), syntax::isPointerType(params.front()->type()) and
+                                           not syntax::isPointerType(params.back()->type()));
+        
+        if (syntax::isPointerType(params.front()->type())) {
+            checkConstIsKept(params.back(), params.front()->nodeType() == AASTNodeType::Value and
+                                            getQualifiers(params.front()->value(), _currentScope).isConst,
+                             "pointer " + params.front()->value());
+        }
+        
+        /* Check if references are being assigned. If not, copy objects */
+        /* If yes, just assign references                               */
+        
+        const bool lIsClass = _ast.isClass(params.front()->type());
+        const bool rIsClass = _ast.isClass(params.back()->type());
+        const bool lIsPtr = syntax::isPointerType(params.front()->type());
+        bool rIsAmp = false;
+        if (params.back()->nodeType() == AASTNodeType::Operator) {
+            AASTOperator & op = *((AASTOperator*)params.back());
+            rIsAmp = op.getOperator() == "&";
+        }
+        const bool rIsPtr = rIsAmp;
+        
+        if (lIsClass and rIsClass and not (lIsPtr and rIsPtr)) {
+            
+            return (AASTOperator*)copyObject(params.front(), params.back());
+        
+        }
+    }
+    
+    const bool isParamless = expr::isParameterlessOperator(op);
+    const bool isUnary     = expr::isUnaryOperator(op);
+    const bool isBinary    = expr::isBinaryOperator(op);
+    
+    if (isParamless) {
+        
+        if (params.size() and not (isUnary or isBinary)) {
+            throw invalid_call(op, currentFunction(), " Too many parameters");
+        }
+        
+        if (not params.size()) {
+            checkParallelJump(op);
+            return expr::parameterless_operator(op);
+        }
+        
+    }
+    
+    /* inc and dec dereference pointers */
+    if ((op == "inc" or op == "dec") and params.size() == 1) {
+        checkIsWritable(params.front(), syntax::isPointerType(params.front()->type()));
+        checkParallelWrite(params.front(), syntax::isPointerType(params.front()->type()));
+    }
+    
+    if (isUnary) {
+        
+        if (not params.size()) {
+            throw invalid_call(op, currentFunction(), " Too few parameters");
+        } else if (params.size() > 1 and not isBinary) {
+            throw invalid_call(op, currentFunction(), " Too many parameters");
+        }
+        
+        if (params.size() == 1) {
+            return expr::unaryOperator(params[0], op);
+        }
+        
+    }
+    
+    if (isBinary) {
+        
+        if (params.size() < 2) {
+            throw invalid_call(op, currentFunction(), " Too few parameters");
+        }
+        
+        return expr::binaryOperator(params, op);
+        
+    }
+    
+    throw invalid_operator(op);
+    
+}
+
+AASTConstruct * Analyzer::analyzeConstruct(ASTConstruct & construct) {
+    
+    if (construct.construct == "for" or construct.construct == "pfor") {
+        return analyzeFor(construct);
+    }
+    
+    static const std::array<NodeType, 4> allowed_node_types = {
+        NodeType::Variable, NodeType::Literal, NodeType::MemberAccess, NodeType::FunCall
+    };
+    
+    if (not contains(allowed_node_types, construct.condition->nodeType)) {
+        
+        throw invalid_syntax("Error: Invalid condition in construct " +
+                             construct.construct + " in function " + currentFunction());
+    }
+    
+    AASTNode * condition = nullptr;
+    
+    /* Analyze condition if construct isn't else           */
+    /* Else doesn't have a condition, everything else does */
+    if (construct.construct != "else") {
+    
+        condition = getFuncallParameter(construct.condition);
+        
+        if (not (expr::isNumericalType(condition->type()) or syntax::isPointerType(condition->type()))) {
+            throw type_mismatch("Error: Conditions must be of numerical or pointer type. Construct: " +
+                                construct.construct + " Function: " + currentFunction());
+        }
+        
+    }
+    
+    /* If construct is elif, expand to else if */
+    const std::string cstruct = construct.construct == "elif" ? "else if" : construct.construct;
+    
+    /* Branches are numbered before the body is analyzed, so nested conditions follow their parent */
+    const int branch = _branchCount;
+    
+    if (construct.construct == "if" or construct.construct == "elif") {
+        ++_branchCount;
+    }
+    
+    AASTConstruct * analyzed = new AASTConstruct(cstruct, condition, analyzeScope(construct.childNodes));
+    analyzed->setOptions(construct.options);
+    
+    if (construct.construct == "if" or construct.construct == "elif") {
+        
+        if (expr::isInstrument()) {
+            analyzed->setBranchCounter(branch);
+        }
+        
+        analyzed->setExpected(_profile.expectedBranch(_mangledName, branch));
+    }
+    
+    return analyzed;
+    
+}
+
+/* If type is to be inferred, inferred type is also stored in ast. */
+AASTConstruct * Analyzer::analyzeFor(ASTConstruct & construct) {
+    
+    ASTFunCall & range = *((ASTFunCall *)construct.condition);
+    
+    const std::string & name = range.function;
+    const std::string & type = construct.vars.at(name);
+    
+    checkIdIsValid(name);
+    
+    std::vector<AASTNode *> bounds;
+    
+    for (ASTNode * param : range.parameters) {
+        
+        AASTNode * bound = expr::dereferencePtr(getFuncallParameter(param));
+        
+        if (not expr::isNumericalType(bound->type()) or expr::isFloatingType(bound->type())) {
+            throw type_mismatch("Error: Bounds of a for loop must be integers. Function: " + currentFunction());
+        }
+        
+        bounds.emplace_back(bound);
+        
+    }
+    
+    if (bounds.size() == 2) {
+        bounds.emplace_back(new AASTValue("1", "int"));
+    }
+    
+    /* Direction of the loop is decided at compile time, so the step must be a non-zero integer constant */
+    long long step = 0;
+    AASTNode * stepNode = bounds[2];
+    
+    if (stepNode->nodeType() == AASTNodeType::Operator and ((AASTOperator *)stepNode)->getOperator() == "-" and
+        ((AASTOperator *)stepNode)->getParameters().size() == 1 and
+        integerConstant(((AASTOperator *)stepNode)->getParameters()[0], step)) {
+        
+        step = -step;
+        
+    } else if (not integerConstant(stepNode, step)) {
+        throw type_mismatch("Error: Step of a for loop must be an integer constant. Function: " + currentFunction());
+    }
+    
+    if (step == 0) {
+        throw type_mismatch("Error: Step of a for loop can't be zero. Function: " + currentFunction());
+    }
+    
+    const bool countsDown = step < 0;
+    
+    std::vector<AASTDeclaration *> initializers = { new AASTDeclaration(name, type, bounds[0]) };
+    
+    /* End bound is evaluated once before the loop, even if it's a variable changed by the loop body, */
+    /* keeping it in a variable also lets the C compiler see it's loop invariant                       */
+    long long constant = 0;
+    AASTNode * end = bounds[1];
+    
+    if (not integerConstant(end, constant)) {
+        initializers.emplace_back(new AASTDeclaration(name + "__end", type, end));
+        end = new AASTValue(name + "__end", type);
+    }
+    
+    AASTValue * variable = new AASTValue(name, type);
+    AASTNode * increment = bounds[2];
+    
+    AASTOperator * condition = new AASTOperator(countsDown ? ">" : "<", "int", { variable, end });
+    increment = new AASTOperator("+=", type, { new AASTValue(name, type), increment });
+    
+    if (construct.construct == "pfor") {
+        checkReductions(construct);
+    }
+    
+    /* Induction variable and bounds are declared in the loop header */
+    for (AASTDeclaration * initializer : initializers) {
+        declareCoroutineVariable(parameter(initializer->getName(), type), (ASTScope *)&construct);
+    }
+    
+    AASTConstruct * analyzed = new AASTConstruct(construct.construct, condition, analyzeScope(construct.childNodes),
+                                                 initializers, increment);
+    analyzed->setOptions(construct.options);
+    analyzed->setReductions(construct.reductions);
+    
+    return analyzed;
+    
+}
+
+AASTDeclaration * Analyzer::analyzeDeclaration(ASTDeclaration & declaration) {
+    
+    useSoa(declaration.type);
+    
+    if (declaration.length != nullptr and _ast.isSoa(declaration.type)) {
+        return analyzeSoaDeclaration(declaration);
+    }
+    
+    if (declaration.length != nullptr) {
+        return analyzeArrayDeclaration(declaration);
+    }
+    
+    std::string decl;
+    
+    checkIdIsValid(declaration.name);
+    
+    std::string type = declaration.type;
+    AASTNode * value = nullptr;
+    
+    static const std::array<NodeType, 4> allowed_node_types = {
+        NodeType::Variable, NodeType::Literal, NodeType::MemberAccess, NodeType::FunCall
+    };
+    
+    if (declaration.value != nullptr) {
+
+        if (not contains(allowed_node_types, declaration.value->nodeType)) {
+            throw invalid_syntax("Error: Invalid value assigned to variable " + declaration.name +
+                                 " in function " + currentFunction());
+        }
+        
+        if (_stackAllocations.declarations.count(&declaration)) {
+            value = stackObject(((ASTVariable*)((ASTFunCall*)declaration.value)->parameters[0])->name);
+        } else {
+            value = getFuncallParameter(declaration.value);
+        }
+        
+        if (type == "var" or type == syntax::pointerForType("var")) {
+            type = value->type();
+            declaration.type = type;
+        }
+        
+        if (syntax::isPointerType(type) and not syntax::isPointerType(value->type())) {
+            addressOfCoroutineVariable(value);
+            value = (AASTNode *)new AASTOperator("&", value->type() + syntax::pointerChar,
+                                                 std::vector<AASTNode *>( { value } ));
+        }
+        
+    }
+    
+    checkQualifiers(declaration.name, type, declaration.qualifiers);
+    
+    if (declaration.qualifiers.isThreadLocal) {
+        throw invalid_declaration("Local variable " + declaration.name + " can't be thread_local, only global variables can");
+    }
+    
+    if (declaration.qualifiers.isConst and not syntax::isPointerType(type) and value == nullptr) {
+        throw invalid_declaration("Constant " + declaration.name + " must be initialized");
+    }
+    
+    if (value != nullptr and syntax::isPointerType(type)) {
+        checkConstIsKept(value, declaration.qualifiers.isConst, "pointer " + declaration.name);
+    }
+    
+    _ast.emplaceVariableIntoScope(parameter(declaration.name, type), declaration.parentScope);
+    
+    /* Constants of coroutines are assigned when they're restored, const is only checked by the analyzer */
+    type_qualifiers qualifiers = declaration.qualifiers;
+    
+    if (_isAsync and not syntax::isPointerType(type)) {
+        qualifiers.isConst = false;
+    }
+    
+    parameter variable(declaration.name, type);
+    variable.qualifiers = qualifiers;
+    declareCoroutineVariable(variable, declaration.parentScope);
+    
+    return new AASTDeclaration(declaration.name, type, value, qualifiers);
+    
+}
+
+AASTDeclaration * Analyzer::analyzeArrayDeclaration(ASTDeclaration & declaration) {
+    
+    checkIdIsValid(declaration.name);
+    
+    std::string elementType = declaration.type;
+    elementType.pop_back();
+    
+    AASTNode * length = getFuncallParameter(declaration.length);
+    
+    if (not expr::isNumericalType(length->type()) or expr::isFloatingType(length->type())) {
+        throw invalid_declaration("Length of array " + declaration.name + " must be an integer");
+    }
+    
+    const bool isObject = not syntax::isPointerType(elementType) and _ast.isClass(elementType);
+    const std::string cType = translateType(elementType);
     
-    std::string type = declaration.type;
     AASTNode * value = nullptr;
     
-    static const std::array<NodeType, 4> allowed_node_types = {
-        NodeType::Variable, NodeType::Literal, NodeType::MemberAccess, NodeType::FunCall
+    if (declaration.onHeap) {
+        
+        const std::string lengthName = NameMangler::arrayLengthName(declaration.name);
+        std::string allocation = "malloc(sizeof(" + cType + ") * " + lengthName + ")";
+        
+        /* Size of an over-aligned class is a multiple of it's alignment, so aligned_alloc can be used */
+        if (_ast.isOveraligned(elementType)) {
+            allocation = "aligned_alloc(" + std::to_string(_layout.typeAlignment(elementType)) + ", sizeof(" + cType +
+                         ") * " + lengthName + ")";
+        }
+        
+        /* Vtable pointers of elements are set by assigning a compound literal to each element */
+        if (isObject) {
+            allocation = "({ " + cType + " * _array__ = " + allocation + "; " +
+                         "for (" + translateType("int") + " _i__ = 0; _i__ < " + lengthName + "; ++_i__) { " +
+                         "_array__[_i__] = (" + cType + ")" + vtableInitializerList(elementType) + "; } " +
+                         "_array__; })";
+        }
+        
+        value = new AASTValue(allocation, declaration.type);
+        
+    } else if (isObject) {
+        
+        /* GNU range designator sets vtable pointers of all elements */
+        value = new AASTValue("{ [0 ... " + length->value() + " - 1] = " + vtableInitializerList(elementType) + " }",
+                              declaration.type);
+        
+    }
+    
+    _ast.emplaceVariableIntoScope(parameter(declaration.name, declaration.type), declaration.parentScope);
+    _arrays[declaration.parentScope][declaration.name] = &declaration;
+    
+    declareCoroutineVariable(parameter(declaration.name, declaration.type), declaration.parentScope, not declaration.onHeap);
+    
+    if (declaration.onHeap) {
+        declareCoroutineVariable(parameter(NameMangler::arrayLengthName(declaration.name), "int"), declaration.parentScope);
+    }
+    
+    return new AASTDeclaration(declaration.name, declaration.type, value, length, declaration.onHeap);
+    
+}
+
+ASTDeclaration * Analyzer::getArray(const std::string & name, ASTScope * scope) {
+    
+    /* Find the scope in which the variable is declared, inner declarations shadow outer ones */
+    for (; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->vars.count(name) and scope->vars.at(name) != "") {
+            
+            if (_arrays.count(scope) and _arrays.at(scope).count(name)) {
+                return _arrays.at(scope).at(name);
+            }
+            
+            return nullptr;
+        }
+        
+    }
+    
+    return nullptr;
+    
+}
+
+AASTOperator * Analyzer::index(std::vector<AASTNode *> & params) {
+    
+    if (params.size() != 2) {
+        throw invalid_call("at", currentFunction(), " Indexing requires an array and an index");
+    }
+    
+    const std::string arrayType = params[0]->type();
+    const std::string indexType = params[1]->type();
+    
+    if (not syntax::isPointerType(arrayType) and not expr::isVectorType(arrayType)) {
+        throw invalid_parameter(currentFunction(), "(at)", params[0]->value());
+    }
+    
+    if (not expr::isNumericalType(indexType) or expr::isFloatingType(indexType)) {
+        throw invalid_parameter(currentFunction(), "(at)", params[1]->value());
+    }
+    
+    /* Lanes of vectors are indexed like arrays */
+    if (expr::isVectorType(arrayType)) {
+        return new AASTOperator("[]", expr::vectorElementType(arrayType), params);
+    }
+    
+    std::string elementType = arrayType;
+    elementType.pop_back();
+    
+    return new AASTOperator("[]", elementType, params);
+    
+}
+
+AASTFuncall * Analyzer::vectorBuiltin(ASTFunCall & funcall) {
+    
+    const std::string & name = funcall.function;
+    
+    if (name == "vec_load" or name == "vec_splat") {
+        
+        if (funcall.parameters.size() != 2) {
+            throw invalid_call(name, currentFunction(), " Expected a vector type and a value");
+        }
+        
+        const std::string type = vectorTypeParameter(funcall);
+        AASTValue * cType = new AASTValue(translateType(type), type);
+        
+        AASTNode * value = getFuncallParameter(funcall.parameters[1]);
+        
+        if (name == "vec_load") {
+            checkVectorPointer(value, type, name);
+            return new AASTFuncall(syntax::vectorLoad, type, { cType, value });
+        }
+        
+        value = expr::dereferencePtr(value);
+        
+        if (not expr::isNumericalType(value->type())) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", value->value());
+        }
+        
+        return new AASTFuncall(syntax::vectorSplat, type, { cType, cast(value, expr::vectorElementType(type)) });
+        
+    }
+    
+    std::vector<AASTNode *> params;
+    
+    for (ASTNode * param : funcall.parameters) {
+        params.emplace_back(getFuncallParameter(param));
+    }
+    
+    if (name == "vec_store") {
+        
+        if (params.size() != 2) {
+            throw invalid_call(name, currentFunction(), " Expected a pointer and a vector");
+        }
+        
+        params[1] = expr::dereferencePtr(params[1]);
+        
+        if (not expr::isVectorType(params[1]->type())) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", params[1]->value());
+        }
+        
+        checkVectorPointer(params[0], params[1]->type(), name);
+        
+        return new AASTFuncall(syntax::vectorStore, "void", params);
+        
+    }
+    
+    if (params.empty()) {
+        throw invalid_call(name, currentFunction(), " Too few parameters");
+    }
+    
+    params[0] = expr::dereferencePtr(params[0]);
+    const std::string type = params[0]->type();
+    
+    if (not expr::isVectorType(type)) {
+        throw invalid_parameter(currentFunction(), "(" + name + ")", params[0]->value());
+    }
+    
+    if (syntax::vectorReductions.count(name)) {
+        
+        if (params.size() != 1) {
+            throw invalid_call(name, currentFunction(), " Too many parameters");
+        }
+        
+        params.emplace_back(new AASTValue(syntax::vectorReductions.at(name), ""));
+        
+        return new AASTFuncall(syntax::vectorReduce, expr::vectorElementType(type), params);
+        
+    }
+    
+    /* vec_shuffle selects lanes of one or two vectors, indices of the second vector start at lanes */
+    const bool twoVectors = params.size() > 1 and expr::isVectorType(expr::dereferencePtr(params[1])->type());
+    
+    if (twoVectors) {
+        
+        params[1] = expr::dereferencePtr(params[1]);
+        
+        if (params[1]->type() != type) {
+            throw type_mismatch("Error: Shuffled vectors must be of the same type. Function: " + currentFunction());
+        }
+    }
+    
+    const size_t first = twoVectors ? 2 : 1;
+    /* Type was already checked to be a vector type, so the number of lanes is positive */
+    const long long lanes = expr::vectorLanes(type);
+    
+    if (params.size() - first != (size_t)lanes) {
+        throw invalid_call(name, currentFunction(), " Expected " + std::to_string(lanes) + " lane indices");
+    }
+    
+    /* Indices must be integer constants */
+    for (size_t i = first; i < params.size(); ++i) {
+        
+        long long index = -1;
+        
+        if (not integerConstant(params[i], index) or index < 0 or index >= lanes * (twoVectors ? 2 : 1)) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", params[i]->value());
+        }
+        
+    }
+    
+    return new AASTFuncall(twoVectors ? "__builtin_shufflevector" : syntax::vectorShuffle, type, params);
+    
+}
+
+AASTNode * Analyzer::hintBuiltin(const std::string & name, std::vector<AASTNode *> & params) {
+    
+    const size_t maxParams = name == "prefetch" ? 3 : name == "assume_aligned" ? 2 : 1;
+    const size_t minParams = name == "assume_aligned" ? 2 : 1;
+    
+    if (params.size() < minParams) {
+        throw invalid_call(name, currentFunction(), " Too few parameters");
+    }
+    if (params.size() > maxParams) {
+        throw invalid_call(name, currentFunction(), " Too many parameters");
+    }
+    
+    /* Branch hints take a condition and return it as an int */
+    if (name == "likely" or name == "unlikely") {
+        
+        AASTNode * condition = expr::dereferencePtr(params[0]);
+        
+        if (not expr::isNumericalType(condition->type()) or expr::isVectorType(condition->type())) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", condition->value());
+        }
+        
+        AASTOperator * truthValue = new AASTOperator("!", "int", { new AASTOperator("!", "int", { condition }) });
+        
+        return new AASTFuncall("__builtin_expect", "int", { truthValue, new AASTValue(name == "likely" ? "1" : "0",
+                                                                                      "int") });
+    }
+    
+    /* Pointers are passed as they are, prefetch and assume_aligned work with addresses, not values */
+    if (name == "prefetch" or name == "assume_aligned") {
+        
+        if (not syntax::isPointerType(params[0]->type())) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", params[0]->value());
+        }
+        
+        for (size_t i = 1; i < params.size(); ++i) {
+            
+            long long value;
+            
+            /* Prefetch takes read (0) or write (1) and temporal locality from 0 to 3 */
+            /* Alignment must be a power of two                                       */
+            const bool valid = integerConstant(params[i], value) and (name == "prefetch" ?
+                                                                      value >= 0 and value <= (i == 1 ? 1 : 3) :
+                                                                      value > 0 and not (value & (value - 1)));
+            
+            if (not valid) {
+                throw invalid_parameter(currentFunction(), "(" + name + ")", params[i]->value());
+            }
+        }
+        
+        if (name == "prefetch") {
+            return new AASTFuncall("__builtin_prefetch", "void", params);
+        }
+        
+        return new AASTCast(new AASTFuncall("__builtin_assume_aligned", "void*", params), params[0]->type());
+    }
+    
+    AASTNode * value = expr::dereferencePtr(params[0]);
+    const std::string type = value->type();
+    
+    if (not expr::isNumericalType(type) or expr::isFloatingType(type)) {
+        throw invalid_parameter(currentFunction(), "(" + name + ")", value->value());
+    }
+    
+    /* Bits are counted in an unsigned integer of the same width, narrow integers are widened to 32 bits */
+    int width = 64;
+    
+    if (type == "i32" or type == "u32") {
+        width = 32;
+    } else if (type == "i16" or type == "u16") {
+        width = 16;
+    } else if (type == "i8" or type == "u8" or type == "char" or type == "uchar") {
+        width = 8;
+    }
+    
+    const std::string unsignedType = "u" + std::to_string(width);
+    const std::string suffix = width == 64 ? "ll" : "";
+    
+    /* Byte order of single bytes can't be reversed */
+    if (name == "bswap") {
+        
+        if (width == 8) {
+            throw invalid_parameter(currentFunction(), "(" + name + ")", value->value());
+        }
+        
+        AASTFuncall * swapped = new AASTFuncall("__builtin_bswap" + std::to_string(width), unsignedType,
+                                                { cast(value, unsignedType) });
+        
+        return cast(swapped, type);
+    }
+    
+    if (name == "popcount") {
+        return new AASTFuncall("__builtin_popcount" + suffix, "int", { cast(value, unsignedType) });
+    }
+    
+    /* clz and ctz are translated to helpers, which return the width of the operand for zero */
+    /* Narrow integers are counted in 32 bits, a bit above the operand stops ctz at it's width */
+    _ast.setUsesBitCounts();
+    
+    const int helperWidth = width == 64 ? 64 : 32;
+    const std::string helperType = "u" + std::to_string(helperWidth);
+    AASTNode * bits = cast(value, unsignedType);
+    
+    if (width < 32) {
+        bits = cast(bits, helperType);
+    }
+    
+    if (name == "ctz" and width < 32) {
+        bits = new AASTOperator("|", helperType, { bits, new AASTValue(std::to_string(1 << width), helperType) });
+    }
+    
+    const std::string & helper = name == "clz" ? syntax::countLeadingZeros : syntax::countTrailingZeros;
+    AASTNode * result = new AASTFuncall(helper + std::to_string(helperWidth), "int", { bits });
+    
+    if (name == "clz" and width < 32) {
+        result = new AASTOperator("-", "int", { result, new AASTValue(std::to_string(32 - width), "int") });
+    }
+    
+    return result;
+    
+}
+
+bool Analyzer::integerConstant(const AASTNode * node, long long & value) {
+    
+    if (node->nodeType() != AASTNodeType::Value or not expr::isNumericalType(node->type()) or
+        expr::isFloatingType(node->type())) {
+        return false;
+    }
+    
+    try {
+        value = std::stoll(node->value());
+    } catch (const std::exception & e) {
+        return false;
+    }
+    
+    return true;
+    
+}
+
+AASTFuncall * Analyzer::atomicBuiltin(ASTFunCall & funcall) {
+    
+    const std::string & name = funcall.function;
+    const bool isCas = name == "cas" or name == "cas_weak";
+    
+    /* Number of parameters preceding optional memory orders, cas takes a success and a failure order */
+    const size_t operands = name == "atomic_load" ? 1 : isCas ? 3 : 2;
+    const size_t orders = isCas ? 2 : 1;
+    
+    if (funcall.parameters.size() < operands or funcall.parameters.size() > operands + orders) {
+        throw invalid_call(name, currentFunction(), " Invalid number of parameters");
+    }
+    
+    if (funcall.parameters[0]->nodeType != NodeType::Variable) {
+        throw invalid_call(name, currentFunction(), " First parameter must be an atomic variable");
+    }
+    
+    parameter var = getVariable(*(ASTVariable *)funcall.parameters[0]);
+    const std::string type = var.type;
+    
+    if (not getQualifiers(var.name, funcall.parameters[0]->parentScope).isAtomic) {
+        throw invalid_call(name, currentFunction(), " Variable " + var.name + " isn't atomic");
+    }
+    
+    /* GCC doesn't scale atomic pointer arithmetic by the size of elements and there are no atomic */
+    /* floating point read-modify-write operations, fetch operations only work with integers      */
+    if (name.compare(0, 6, "fetch_") == 0 and (syntax::isPointerType(type) or expr::isFloatingType(type))) {
+        throw invalid_call(name, currentFunction(), " Variable " + var.name + " must be of integer type");
+    }
+    
+    /* Atomic operations take the address of the variable, even if the variable is a pointer */
+    std::vector<AASTNode *> params = { new AASTValue("(&" + var.name + ")", syntax::pointerForType(type)) };
+    
+    /* Expected value of cas is overwritten with the current value if the exchange fails */
+    if (isCas) {
+        
+        if (funcall.parameters[1]->nodeType != NodeType::Variable) {
+            throw invalid_call(name, currentFunction(), " Expected value must be stored in a variable");
+        }
+        
+        AASTNode * expected = getFuncallParameter(funcall.parameters[1]);
+        
+        if (expected->type() != type) {
+            throw type_mismatch("Error: Expected value " + expected->value() + " must be of type " + type +
+                                " in function " + currentFunction());
+        }
+        
+        checkIsWritable(expected, false);
+        checkParallelWrite(expected, false);
+        
+        /* & operator doesn't take address of pointers, so the address is taken directly */
+        params.emplace_back(new AASTValue("(&" + expected->value() + ")", syntax::pointerForType(type)));
+        delete expected;
+        
+    }
+    
+    /* Stored values are converted to the type of the variable */
+    for (size_t i = isCas ? 2 : 1; i < operands; ++i) {
+        
+        AASTNode * value = getFuncallParameter(funcall.parameters[i]);
+        
+        if (not syntax::isPointerType(type)) {
+            value = expr::dereferencePtr(value);
+        }
+        
+        params.emplace_back(cast(value, type));
+        
+    }
+    
+    std::string order = memoryOrder(funcall.parameters.size() > operands ? funcall.parameters[operands] : nullptr, name);
+    
+    if ((name == "atomic_load" and (order == "memory_order_release" or order == "memory_order_acq_rel")) or
+        (name == "atomic_store" and (order == "memory_order_acquire" or order == "memory_order_acq_rel"))) {
+        throw invalid_call(name, currentFunction(), " Invalid memory order " + order);
+    }
+    
+    params.emplace_back(new AASTValue(order, "int"));
+    
+    if (isCas) {
+        
+        /* Failed cas only loads the value, so it can't use a release order, by default the strongest */
+        /* order allowed by the success order is used                                                 */
+        std::string failure = order;
+        
+        if (funcall.parameters.size() > operands + 1) {
+            failure = memoryOrder(funcall.parameters[operands + 1], name);
+        } else if (order == "memory_order_release") {
+            failure = "memory_order_relaxed";
+        } else if (order == "memory_order_acq_rel") {
+            failure = "memory_order_acquire";
+        }
+        
+        if (failure == "memory_order_release" or failure == "memory_order_acq_rel") {
+            throw invalid_call(name, currentFunction(), " Invalid failure memory order " + failure);
+        }
+        
+        params.emplace_back(new AASTValue(failure, "int"));
+        
+        const std::string strength = name == "cas" ? "strong" : "weak";
+        return new AASTFuncall("atomic_compare_exchange_" + strength + "_explicit", "int", params);
+        
+    }
+    
+    if (name == "atomic_store") {
+        return new AASTFuncall("atomic_store_explicit", "void", params);
+    }
+    
+    /* atomic_load, exchange and fetch operations return the value of the variable before the operation */
+    const std::string function = name == "atomic_load" ? "atomic_load" : "atomic_" + name;
+    return new AASTFuncall(function + "_explicit", type, params);
+    
+}
+
+std::string Analyzer::memoryOrder(ASTNode * order, const std::string & builtin) {
+    
+    if (order == nullptr) {
+        return "memory_order_seq_cst";
+    }
+    
+    if (order->nodeType != NodeType::Variable or not expr::isMemoryOrder(((ASTVariable *)order)->name)) {
+        throw invalid_call(builtin, currentFunction(), " Memory order must be one of relaxed, acquire, release, "
+                           "acq_rel or seq_cst");
+    }
+    
+    return "memory_order_" + ((ASTVariable *)order)->name;
+    
+}
+
+AASTFuncall * Analyzer::spawn(ASTFunCall & funcall) {
+    
+    const size_t size = funcall.parameters.size();
+    
+    if ((size != 1 and size != 2) or funcall.parameters.back()->nodeType != NodeType::FunCall) {
+        throw invalid_call("spawn", currentFunction(), " Expected an optional variable and a function call");
+    }
+    
+    ASTFunCall & spawned = *(ASTFunCall *)funcall.parameters.back();
+    
+    if (spawned.object != nullptr) {
+        throw invalid_call("spawn", currentFunction(), " Only functions can be spawned, not methods");
+    }
+    
+    /* Task group is synced when the resume function returns, tasks would write results into the stack */
+    if (_isAsync) {
+        throw invalid_call("spawn", currentFunction(), " Async functions can't spawn tasks");
+    }
+    
+    AASTNode * node = analyzeFunCall(spawned);
+    
+    /* Only calls of Kobeři-C functions keep the mangled function name, operators and builtins don't */
+    std::vector<std::string> paramTypes;
+    if (node->nodeType() == AASTNodeType::Funcall) {
+        for (AASTNode * param : ((AASTFuncall *)node)->getParameters()) {
+            paramTypes.emplace_back(param->type());
+        }
+    }
+    
+    if (node->nodeType() != AASTNodeType::Funcall or
+        ((AASTFuncall *)node)->getName() != NameMangler::mangleName(spawned.function, paramTypes)) {
+        
+        delete node;
+        throw invalid_call("spawn", currentFunction(), " Only functions can be spawned");
+    }
+    
+    if (_ast.isAsyncFunction(((AASTFuncall *)node)->getName())) {
+        delete node;
+        throw invalid_call("spawn", currentFunction(), " Async functions can't be spawned, they create coroutines");
+    }
+    
+    AASTFuncall * call = (AASTFuncall *)node;
+    
+    spawned_function function;
+    function.name = call->getName();
+    function.type = call->type();
+    function.parameters = paramTypes;
+    
+    _aast.emplaceSpawnedFunction(function);
+    _spawnsTasks = true;
+    
+    std::vector<AASTNode *> params = {
+        new AASTValue("&" + syntax::taskGroupVariable, syntax::pointerForType(syntax::taskGroup))
+    };
+    
+    /* Result is written by the task, so the variable must live until the function returns and tasks */
+    /* are synced, variables of nested scopes could go out of scope while the task is still running  */
+    if (size == 2) {
+        
+        if (function.type == "void") {
+            delete call;
+            throw invalid_call("spawn", currentFunction(), " Function " + spawned.function + " doesn't return a value");
+        }
+        
+        if (funcall.parameters[0]->nodeType != NodeType::Variable) {
+            delete call;
+            throw invalid_call("spawn", currentFunction(), " Result can only be stored in a variable");
+        }
+        
+        const std::string & name = ((ASTVariable *)funcall.parameters[0])->name;
+        ASTScope * scope = _currentScope;
+        
+        while (scope != nullptr and not (scope->vars.count(name) and scope->vars.at(name) != "")) {
+            scope = scope->parentScope;
+        }
+        
+        if (scope == nullptr or scope->nodeType != NodeType::Function) {
+            delete call;
+            throw invalid_call("spawn", currentFunction(), " Result variable " + name +
+                               " must be declared in the outermost scope of the function");
+        }
+        
+        AASTNode * result = getFuncallParameter(funcall.parameters[0]);
+        
+        checkIsAssignable(result);
+        checkIsWritable(result, false);
+        checkParallelWrite(result, false);
+        
+        if (result->type() != function.type) {
+            throw type_mismatch("Error: Result of function " + spawned.function + " of type " + function.type +
+                                " can't be stored in variable " + name + " of type " + result->type() + ". ");
+        }
+        
+        /* & operator doesn't take address of pointers, so the address is taken directly */
+        params.emplace_back(new AASTValue("(&" + name + ")", syntax::pointerForType(function.type)));
+        delete result;
+        
+    } else if (function.type != "void") {
+        params.emplace_back(new AASTValue("NULL", syntax::pointerForType(function.type)));
+    }
+    
+    /* Parameters are evaluated by the spawning function and stored in the task */
+    for (AASTNode * param : call->getParameters()) {
+        params.emplace_back(param);
+    }
+    
+    call->getParameters().clear();
+    delete call;
+    
+    return new AASTFuncall(NameMangler::taskSpawnName(function.name), "void", params);
+    
+}
+
+AASTFuncall * Analyzer::sync(ASTFunCall & funcall) {
+    
+    if (not funcall.parameters.empty()) {
+        throw invalid_call("sync", currentFunction(), " Too many parameters");
+    }
+    
+    if (_isAsync) {
+        throw invalid_call("sync", currentFunction(), " Async functions can't spawn tasks");
+    }
+    
+    _spawnsTasks = true;
+    
+    return new AASTFuncall(syntax::taskSync, "void", {
+        new AASTValue("&" + syntax::taskGroupVariable, syntax::pointerForType(syntax::taskGroup))
+    });
+    
+}
+
+AASTNode * Analyzer::await(ASTFunCall & funcall) {
+    
+    if (&funcall != _awaitCall) {
+        throw invalid_call("await", currentFunction(), " Await must be a statement or the value of a declaration, set or return");
+    }
+    
+    checkSuspension("await");
+    
+    if (funcall.parameters.size() != 1) {
+        throw invalid_call("await", currentFunction(), " Expected a coroutine or a call of an async function");
+    }
+    
+    AASTNode * awaited = getFuncallParameter(funcall.parameters[0]);
+    
+    if (awaited->type() != syntax::coroutine) {
+        throw type_mismatch("Error: Only coroutines can be awaited, got value of type " + awaited->type() +
+                            " in function " + currentFunction() + ". ");
+    }
+    
+    /* Coroutines created by await are owned by the awaiting coroutine, which also reads their result */
+    const bool isCall = awaited->nodeType() == AASTNodeType::Funcall and
+                        _ast.isAsyncFunction(((AASTFuncall *)awaited)->getName());
+    const std::string function = isCall ? ((AASTFuncall *)awaited)->getName() : "";
+    const std::string type = isCall ? _ast.getFunctionReturnType(function) : "void";
+    
+    const bool isStatement = _currentScope != nullptr and
+                             std::find(_currentScope->childNodes.begin(), _currentScope->childNodes.end(),
+                                       (ASTNode *)&funcall) != _currentScope->childNodes.end();
+    
+    if (type == "void" and not isStatement) {
+        throw type_mismatch("Error: Awaited coroutine doesn't return a value in function " + currentFunction() + ". ");
+    }
+    
+    const std::string awaitedCoroutine = syntax::coroutineVariable + "->awaited";
+    
+    std::vector<AASTNode *> statements;
+    
+    statements.emplace_back(new AASTOperator("=", "void", { new AASTValue(awaitedCoroutine, syntax::coroutine), awaited }));
+    
+    /* Awaited coroutine is resumed every time the awaiting coroutine is resumed, until it finishes */
+    AASTValue * resume = new AASTValue(syntax::coroutineResume + "(" + awaitedCoroutine + ")", "int");
+    statements.emplace_back(new AASTConstruct("while", resume, new AASTScope(suspend())));
+    
+    AASTValue * result = nullptr;
+    
+    /* Value is moved into the frame of the awaiting coroutine, so the awaited coroutine can be freed */
+    if (type != "void" and not isStatement) {
+        
+        const std::string field = syntax::coroutineFrameVariable + "->" +
+                                  frameField(parameter("_co__value" + std::to_string(_suspendPoints), type));
+        const std::string frame = NameMangler::coroutineFrameName(function);
+        
+        statements.emplace_back(new AASTValue(field + " = ((" + frame + " *)" + awaitedCoroutine + ")->" +
+                                              syntax::coroutineResult, "void"));
+        
+        result = new AASTValue(field, type);
+        
+    }
+    
+    if (isCall) {
+        statements.emplace_back(new AASTFuncall("free", "void", { new AASTValue(awaitedCoroutine, syntax::coroutine) }));
+    }
+    
+    if (isStatement) {
+        return new AASTScope(statements);
+    }
+    
+    _awaits.emplace_back(new AASTScope(statements));
+    
+    return result;
+    
+}
+
+AASTScope * Analyzer::yield(ASTFunCall & funcall) {
+    
+    checkSuspension("yield");
+    
+    if (not funcall.parameters.empty()) {
+        throw invalid_call("yield", currentFunction(), " Too many parameters");
+    }
+    
+    return new AASTScope(suspend());
+    
+}
+
+ASTFunCall * Analyzer::statementAwait(ASTNode * statement) {
+    
+    auto isAwait = [](ASTNode * node) -> bool {
+        return node != nullptr and node->nodeType == NodeType::FunCall and ((ASTFunCall *)node)->function == "await" and
+               ((ASTFunCall *)node)->object == nullptr;
     };
     
-    if (declaration.value != nullptr) {
+    if (isAwait(statement)) {
+        return (ASTFunCall *)statement;
+    }
+    
+    if (statement->nodeType == NodeType::Declaration and isAwait(((ASTDeclaration *)statement)->value)) {
+        return (ASTFunCall *)((ASTDeclaration *)statement)->value;
+    }
+    
+    if (statement->nodeType != NodeType::FunCall) {
+        return nullptr;
+    }
+    
+    ASTFunCall & funcall = *(ASTFunCall *)statement;
+    
+    const bool isSet = funcall.function == "set" and funcall.parameters.size() == 2;
+    const bool isReturn = funcall.function == "return" and funcall.parameters.size() == 1;
+    
+    if (funcall.object == nullptr and (isSet or isReturn) and isAwait(funcall.parameters.back())) {
+        return (ASTFunCall *)funcall.parameters.back();
+    }
+    
+    return nullptr;
+    
+}
 
-        if (not contains(allowed_node_types, declaration.value->nodeType)) {
-            throw invalid_syntax("Error: Invalid value assigned to variable " + declaration.name +
-                                 " in function " + currentFunction());
+void Analyzer::checkSuspension(const std::string & name) {
+    
+    if (not _isAsync) {
+        throw invalid_call(name, currentFunction(), " Only async functions can suspend");
+    }
+    
+    /* Iterations of parallel loops run on other threads, they can't return from the resume function */
+    for (ASTScope * scope = _currentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        if (scope->nodeType == NodeType::Construct and ((ASTConstruct *)scope)->construct == "pfor") {
+            throw invalid_call(name, currentFunction(), " Coroutines can't suspend inside parallel loops");
         }
         
-        value = getFuncallParameter(declaration.value);
+    }
+    
+}
+
+std::vector<AASTNode *> Analyzer::suspend() {
+    
+    const size_t index = ++_suspendPoints;
+    
+    std::vector<AASTNode *> save;
+    std::vector<AASTNode *> restore;
+    
+    for (const parameter & variable : visibleVariables()) {
+        
+        const std::string field = syntax::coroutineFrameVariable + "->" + frameField(variable);
         
-        if (type == "var" or type == syntax::pointerForType("var")) {
-            type = value->type();
-            declaration.type = type;
+        save.emplace_back(new AASTValue(field + " = " + variable.name, "void"));
+        restore.emplace_back(new AASTValue(variable.name + " = " + field, "void"));
+        
+    }
+    
+    /* Resume function returns after saving variables and jumps to the label when it's called again */
+    std::vector<AASTNode *> statements = save;
+    
+    statements.emplace_back(new AASTValue(syntax::coroutineVariable + "->state = " + std::to_string(index), "void"));
+    statements.emplace_back(new AASTOperator("return", "void", { new AASTValue("1", "int") }));
+    statements.emplace_back(new AASTValue(NameMangler::suspendLabel(index) + ":", "void"));
+    statements.insert(statements.end(), restore.begin(), restore.end());
+    
+    return statements;
+    
+}
+
+std::vector<parameter> Analyzer::visibleVariables() {
+    
+    std::vector<parameter> variables;
+    std::unordered_set<std::string> names;
+    
+    /* Variables are declared before the suspension point in the current scope or one of it's parents */
+    for (ASTScope * scope = _currentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        for (const coroutine_variable & var : _coroutineVariables) {
+            
+            if (var.scope != scope) {
+                continue;
+            }
+            
+            const std::string & name = var.variable.name;
+            
+            if (names.count(name)) {
+                throw invalid_declaration("Variable " + name + " in function " + currentFunction() +
+                                          " shadows another variable, which is visible at a suspension point");
+            }
+            
+            if (var.isStackArray) {
+                throw invalid_declaration("Stack array " + name + " in function " + currentFunction() +
+                                          " can't be kept across a suspension point, declare it with :heap");
+            }
+            
+            if (_addressedVariables.count({ scope, name })) {
+                throw invalid_declaration("Address of variable " + name + " in function " + currentFunction() +
+                                          " is taken, so it can't be kept across a suspension point, declare it " +
+                                          "as an array with :heap");
+            }
+            
+            names.emplace(name);
+            variables.emplace_back(var.variable);
+            _suspendedVariables.emplace(scope, name);
+            
         }
         
-        if (syntax::isPointerType(type) and not syntax::isPointerType(value->type())) {
-            value = (AASTNode *)new AASTOperator("&", value->type() + syntax::pointerChar,
-                                                 std::vector<AASTNode *>( { value } ));
+        if (scope->nodeType == NodeType::Function) {
+            break;
         }
         
     }
     
-    _ast.emplaceVariableIntoScope(parameter(declaration.name, type), declaration.parentScope);
+    return variables;
+    
+}
+
+void Analyzer::declareCoroutineVariable(const parameter & variable, ASTScope * scope, bool isStackArray) {
+    
+    if (not _isAsync) {
+        return;
+    }
+    
+    coroutine_variable var;
+    
+    var.scope = scope;
+    var.variable = variable;
+    var.isStackArray = isStackArray;
+    
+    _coroutineVariables.emplace_back(var);
+    
+}
+
+void Analyzer::addressOfCoroutineVariable(AASTNode * referenced) {
+    
+    if (not _isAsync or referenced->nodeType() != AASTNodeType::Value or syntax::isPointerType(referenced->type())) {
+        return;
+    }
+    
+    /* Attributes of local objects are stored in the object, attributes accessed through pointers aren't */
+    std::string name = referenced->value();
+    
+    if (name.find("->") != std::string::npos) {
+        return;
+    }
+    
+    name = name.substr(0, name.find('.'));
+    
+    for (ASTScope * scope = _currentScope; scope != nullptr; scope = scope->parentScope) {
+        
+        if (not scope->vars.count(name) or scope->vars.at(name) == "") {
+            continue;
+        }
+        
+        if (_suspendedVariables.count({ scope, name })) {
+            throw invalid_declaration("Address of variable " + name + " in function " + currentFunction() +
+                                      " can't be taken, because it's kept across a suspension point, declare it " +
+                                      "as an array with :heap");
+        }
+        
+        _addressedVariables.emplace(scope, name);
+        return;
+        
+    }
+    
+}
+
+std::string Analyzer::frameField(const parameter & variable) {
+    
+    const std::string key = variable.name + " " + variable.type;
+    
+    if (_frameFields.count(key)) {
+        return _frameFields.at(key);
+    }
+    
+    /* Variables of different types declared in different scopes may share a name */
+    std::string field = variable.name;
+    
+    for (const auto & f : _frameFields) {
+        
+        if (f.second == field) {
+            field = variable.name + "_co__" + std::to_string(_frameFields.size());
+            break;
+        }
+        
+    }
+    
+    _frameFields[key] = field;
+    _coroutineFrame.emplace_back(AASTDeclaration(field, variable.type, nullptr, variable.qualifiers));
+    
+    return field;
+    
+}
+
+std::string Analyzer::vectorTypeParameter(ASTFunCall & funcall) {
+    
+    ASTNode * param = funcall.parameters[0];
+    
+    if (param->nodeType != NodeType::Variable or not expr::isVectorType(((ASTVariable *)param)->name)) {
+        throw invalid_call(funcall.function, currentFunction(), " First parameter must be a vector type");
+    }
     
-    return new AASTDeclaration(declaration.name, type, value);
+    _ast.setUsesVectors();
+    
+    return ((ASTVariable *)param)->name;
+    
+}
+
+void Analyzer::checkVectorPointer(AASTNode * pointer, const std::string & vectorType, const std::string & builtin) {
+    
+    std::string type = pointer->type();
+    
+    if (not syntax::isPointerType(type)) {
+        throw invalid_parameter(currentFunction(), "(" + builtin + ")", pointer->value());
+    }
+    
+    type.pop_back();
+    
+    const std::string element = expr::vectorElementType(vectorType);
+    
+    /* Default Kobeři-C types have the same width as 64 bit vector elements */
+    const bool sameWidth = (type == "num" and element == "f64") or (type == "int" and element == "i64") or
+                           (type == "uint" and element == "u64");
+    
+    if (type != element and type != "void" and not sameWidth) {
+        throw type_mismatch("Error: Can't access elements of type " + type + " as " + vectorType +
+                            ". Function: " + currentFunction());
+    }
+    
+}
+
+AASTDeclaration * Analyzer::analyzeSoaDeclaration(ASTDeclaration & declaration) {
+    
+    checkIdIsValid(declaration.name);
+    
+    AASTNode * length = expr::dereferencePtr(getFuncallParameter(declaration.length));
+    
+    if (not expr::isNumericalType(length->type()) or expr::isFloatingType(length->type())) {
+        throw invalid_declaration("Length of container " + declaration.name + " must be an integer");
+    }
+    
+    const std::string & className = _ast.getSoaClass(declaration.type);
+    const std::string soa = "_soa__";
+    
+    /* Columns are allocated one by one after the length is set */
+    std::string allocation = "({ " + declaration.type + " " + soa + " = { " + length->value() + " }; ";
+    
+    for (const parameter & attribute : _ast.getClass(className).attributes) {
+        
+        /* Objects inside columns would need their vtables initialized */
+        if (not syntax::isPointerType(attribute.type) and _ast.isClass(attribute.type)) {
+            throw invalid_declaration("Class " + className + " can't be stored in a container, attribute " +
+                                      attribute.name + " is an object");
+        }
+        
+        allocation += soa + "." + attribute.name + " = malloc(sizeof(" + translateType(attribute.type) + ") * " +
+                      soa + "." + syntax::soaLength + "); ";
+        
+    }
+    
+    allocation += soa + "; })";
+    
+    delete length;
+    
+    _ast.emplaceVariableIntoScope(parameter(declaration.name, declaration.type), declaration.parentScope);
+    declareCoroutineVariable(parameter(declaration.name, declaration.type), declaration.parentScope);
+    
+    return new AASTDeclaration(declaration.name, declaration.type, new AASTValue(allocation, declaration.type));
+    
+}
+
+AASTValue Analyzer::soaAccess(ASTMemberAccess & attribute, const std::string & name, const std::string & type) {
+    
+    const std::vector<ASTNode *> & order = attribute.accessOrder;
+    
+    std::string container = type;
+    if (syntax::isPointerType(container)) {
+        container.pop_back();
+    }
+    
+    const std::string prefix = name + (syntax::isPointerType(type) ? "->" : ".");
+    
+    if (order.size() == 2 and order[1]->nodeType == NodeType::Variable and ((ASTVariable *)order[1])->name == "length") {
+        return AASTValue(prefix + syntax::soaLength, "int", false);
+    }
+    
+    if (order.size() != 3 or order[2]->nodeType != NodeType::Variable) {
+        throw invalid_attribute_access(currentFunction(), "Elements of container " + name +
+                                       " must be accessed as [" + name + " index attribute]");
+    }
+    
+    AASTNode * index = expr::dereferencePtr(getFuncallParameter(order[1]));
+    
+    if (not expr::isNumericalType(index->type()) or expr::isFloatingType(index->type())) {
+        throw invalid_parameter(currentFunction(), "[" + name + "]", index->value());
+    }
+    
+    const _class & cls = _ast.getClass(_ast.getSoaClass(container));
+    const std::string & attributeName = ((ASTVariable *)order[2])->name;
+    
+    if (not cls.hasVar(attributeName)) {
+        throw invalid_attribute_access(currentFunction(), "Class " + cls.className + " has no attribute " + attributeName);
+    }
+    
+    const std::string value = prefix + attributeName + "[" + index->value() + "]";
+    delete index;
+    
+    return AASTValue(value, cls.getVarType(attributeName), true);
+    
+}
+
+AASTScope * Analyzer::deleteSoa(AASTNode * container) {
+    
+    std::string type = container->type();
+    const bool isPtr = syntax::isPointerType(type);
+    
+    if (isPtr) {
+        type.pop_back();
+    }
+    
+    const std::string prefix = container->value() + (isPtr ? "->" : ".");
+    
+    std::vector<AASTNode *> body;
+    
+    for (const parameter & attribute : _ast.getClass(_ast.getSoaClass(type)).attributes) {
+        
+        AASTValue * column = new AASTValue(prefix + attribute.name, syntax::pointerForType(attribute.type));
+        body.emplace_back(new AASTFuncall("free", "void", { column }));
+        
+    }
+    
+    body.emplace_back(new AASTOperator("=", "void", {
+        new AASTValue(prefix + syntax::soaLength, "int"), new AASTValue("0", "int")
+    }));
+    
+    delete container;
+    
+    return new AASTScope(body);
+    
+}
+
+void Analyzer::useSoa(const std::string & type) {
+    
+    std::string container = type;
+    if (syntax::isPointerType(container)) {
+        container.pop_back();
+    }
+    
+    if (not _ast.isSoa(container)) {
+        return;
+    }
+    
+    for (AASTClass * cls : _aast.getClasses()) {
+        if (cls->type() == _ast.getSoaClass(container)) {
+            cls->setSoa(true);
+        }
+    }
     
 }
 
@@ -914,6 +2747,21 @@ AASTValue Analyzer::analyzeMemberAccess(ASTMemberAccess & attribute) {
         throw invalid_attribute_access(currentFunction(), "Not enough parameters.");
     }
     
+    if (attribute.accessOrder[0]->nodeType == NodeType::Variable) {
+        
+        const std::string & name = ((ASTVariable *)attribute.accessOrder[0])->name;
+        std::string type = _ast.getVarType(name, attribute.parentScope);
+        
+        if (_ast.isSoa(type) or (syntax::isPointerType(type) and _ast.isSoa(type.substr(0, type.size() - 1)))) {
+            return soaAccess(attribute, name, type);
+        }
+    }
+    
+    /* Only containers can be indexed */
+    if (attribute.accessOrder.size() > 1 and attribute.accessOrder[1]->nodeType != NodeType::Variable) {
+        throw invalid_attribute_access(currentFunction(), "Parameters of [] operator beyond the first operator must be valid identifiers. ");
+    }
+    
     parameter attr;
     
     AASTNode * baseValue;
@@ -928,7 +2776,8 @@ AASTValue Analyzer::analyzeMemberAccess(ASTMemberAccess & attribute) {
         baseVal.type = baseValue->type();
         baseVal.value = baseValue->value();
         
-        if (not syntax::isPointerType(baseVal.type)) {
+        /* Array elements are assignable, values returned from functions aren't */
+        if (not syntax::isPointerType(baseVal.type) and fcall.function != "at") {
             isAssignable = false;
         }
         
@@ -936,6 +2785,11 @@ AASTValue Analyzer::analyzeMemberAccess(ASTMemberAccess & attribute) {
         
         baseVal.name = ((ASTVariable*)attribute.accessOrder[0])->name;
         baseVal.type = _ast.getVarType(baseVal.name, attribute.parentScope);
+        
+        if (getQualifiers(baseVal.name, attribute.parentScope).isAtomic) {
+            throw type_mismatch("Error: Atomic variable " + baseVal.name + " can only be accessed using atomic "
+                                "operations in function " + currentFunction());
+        }
         baseValue = new AASTValue(baseVal.name, baseVal.type, isAssignable);
         
     }
@@ -1065,12 +2919,18 @@ AASTOperator * Analyzer::inlineC(std::vector<AASTNode *> & parameters, ASTFunCal
     
 }
 
-AASTOperator * Analyzer::newObject(const std::string & type) {
+AASTNode * Analyzer::newObject(const std::string & type) {
     
     if (not _ast.isDataType(type)) {
         throw undefined_class(type);
     }
     
+    /* Pooled objects get their vtable pointer from the pool allocator */
+    if (_ast.isPooled(type)) {
+        return new AASTFuncall(NameMangler::poolAllocatorName(type), syntax::pointerForType(type),
+                               std::vector<AASTNode *>());
+    }
+    
     AASTValue * param = new AASTValue(type, type);
     AASTValue * vtableInitializer;
     
@@ -1084,17 +2944,86 @@ AASTOperator * Analyzer::newObject(const std::string & type) {
         vtableInitializer = new AASTValue("0", "vt_init");
     }
     
+    /* Over-aligned objects are allocated by the aligned allocator, which needs their alignment */
+    if (_ast.isOveraligned(type)) {
+        
+        AASTValue * alignment = new AASTValue(std::to_string(_layout.typeAlignment(type)), "int");
+        
+        return new AASTOperator("new", syntax::pointerForType(type),
+                                std::vector<AASTNode *>( { param, alignment, vtableInitializer } ));
+    }
+    
     return new AASTOperator("new", syntax::pointerForType(type),
                             std::vector<AASTNode *>( { param, vtableInitializer } ));
     
 }
 
+AASTValue * Analyzer::stackObject(const std::string & type) {
+    
+    /* Compound literal lives until the end of the enclosing block, just like the pointer */
+    return new AASTValue("&(" + type + ")" + vtableInitializerList(type), syntax::pointerForType(type));
+    
+}
+
+std::string Analyzer::vtableInitializerList(const std::string & type) {
+    
+    std::string list = "{ .vtable = " + NameMangler::vtableName(type);
+    
+    for (const parameter & att : _ast.getClass(type).attributes) {
+        
+        if (not syntax::isPointerType(att.type) and _ast.isClass(att.type)) {
+            list += ", ." + att.name + " = " + vtableInitializerList(att.type);
+        }
+        
+    }
+    
+    return list + " }";
+    
+}
+
+std::string Analyzer::getDeallocator(const std::string & type) {
+    
+    if (syntax::isPointerType(type) or not _ast.isClass(type)) {
+        return "free";
+    }
+    
+    /* Pointer may point to an instance of any subclass, find out which of them are pooled */
+    bool hasSubclasses = false;
+    bool hasPooledSubclasses = false;
+    
+    for (const std::string & c : _ast.getClassOrder()) {
+        
+        if (_ast.hasSuperclass(c, type)) {
+            hasSubclasses = true;
+            hasPooledSubclasses = hasPooledSubclasses or _ast.isPooled(c);
+        }
+        
+    }
+    
+    /* Without subclasses the exact class is known and the object can go straight back to its pool */
+    if (_ast.isPooled(type) and not hasSubclasses) {
+        return NameMangler::poolDeallocatorName(type);
+    }
+    
+    /* Otherwise the pool is looked up at runtime using the object's vtable pointer */
+    if (_ast.isPooled(type) or hasPooledSubclasses) {
+        return syntax::poolRelease;
+    }
+    
+    return "free";
+    
+}
+
 std::string Analyzer::currentFunction() {
     return "(" + _functionType + " " + _functionName + ")";
 }
 
 void Analyzer::analyze() {
     
+    if (expr::getProfileUse() != "") {
+        _profile.load(expr::getProfileUse());
+    }
+    
     kobericMainCheck();
     
     analyzeClasses();
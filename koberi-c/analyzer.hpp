@@ -12,9 +12,26 @@
 #include "analyzed_abstract_syntax_tree.hpp"
 #include "aast_node.hpp"
 #include "traversable_ast.hpp"
+#include "escape_analysis.hpp"
+#include "class_layout.hpp"
+#include "profile_data.hpp"
 #include "expressions.hpp"
 #include "exceptions.hpp"
 
+#include <set>
+
+/* Variable of an async function and the scope it's declared in, variables visible at a suspension point */
+/* are saved into the frame of the coroutine when it suspends and restored when it's resumed            */
+
+struct coroutine_variable {
+    
+    ASTScope * scope;
+    parameter variable;
+    /* Stack arrays can't be copied into the frame */
+    bool isStackArray = false;
+    
+};
+
 /* Analyzer class which iterates over AST nodes and analyzes them        */
 /* Analyzer handles name mangling, type inferrence, type checking etc... */
 /* Analyzer creates an AnalyzedAbstractSyntaxTree                        */
@@ -36,6 +53,41 @@ class Analyzer {
     /* Stores all currently declared variables so destructors can be called on all declared variables. */
     std::vector<ASTDeclaration *> _declarations;
     
+    /* Finds objects created by new, which never escape the current function */
+    EscapeAnalysis _escapeAnalysis;
+    /* Non-escaping objects of the current function, which are allocated on stack instead of heap */
+    stack_allocations _stackAllocations;
+    
+    /* Arranges attributes of classes, reorders attributes of classes marked with :reorder */
+    ClassLayout _layout;
+    
+    /* Counters from an instrumented run, loaded when compiling with --profile-use */
+    ProfileData _profile;
+    /* Mangled name of the current function and the number of it's if/elif conditions, */
+    /* which identify branches in profiles                                              */
+    std::string _mangledName;
+    int _branchCount = 0;
+    
+    /* Set if the current function spawns tasks or syncs, such functions declare a task group */
+    bool _spawnsTasks = false;
+    
+    /* Set if the current function is async, async functions are translated to coroutines */
+    bool _isAsync = false;
+    /* Variables of the current async function in the order they're declared in */
+    std::vector<coroutine_variable> _coroutineVariables;
+    /* Fields of the frame, except for parameters, and names of fields of variables, key is name and type */
+    std::vector<AASTDeclaration> _coroutineFrame;
+    std::unordered_map<std::string, std::string> _frameFields;
+    size_t _suspendPoints = 0;
+    /* Locals are restored into the stack of the resume function, which may be called from a different depth, */
+    /* so variables whose address is taken can't be kept across suspension points, key is scope and name      */
+    std::set<std::pair<ASTScope *, std::string>> _addressedVariables;
+    std::set<std::pair<ASTScope *, std::string>> _suspendedVariables;
+    /* Await which may be analyzed, it must be a statement or the value of a declaration, set or return */
+    ASTFunCall * _awaitCall = nullptr;
+    /* Coroutines are awaited before the statement which uses the awaited value */
+    std::vector<AASTNode *> _awaits;
+    
     void analyzeClasses();
     void analyzeGlobalVars();
     
@@ -47,6 +99,8 @@ class Analyzer {
     
     /* Analyzes a function, checks it for mistakes, prepares it for translation to C */
     void analyzeFunction(ASTFunction & function);
+    /* Returns the name used in profiles of instrumented programs, eg. Vector::add(num) */
+    std::string profileName(const ASTFunction & function);
     
     /* Analyzes a function call, mangles the name */
     AASTNode * analyzeFunCall(ASTFunCall & funcall);
@@ -56,7 +110,10 @@ class Analyzer {
                               const std::string & type, const std::vector<AASTNode *> & params);
     
     AASTOperator * analyzeOperator(const std::string & op, std::vector<AASTNode *> & params);
-    AASTOperator * analyzePrint(std::vector<AASTNode *> & parameters);
+    
+    /* Merges printed values into format strings, so print results in a single printf call, or a single */
+    /* fputs call if only string literals are printed, values with side effects start a new printf call */
+    AASTNode * analyzePrint(std::vector<AASTNode *> & parameters);
     
     /* Analyzes return operator - checks if type matches function return type */
     /* Casts returned value to function's return type if possible             */
@@ -69,25 +126,63 @@ class Analyzer {
     AASTNode * cast(AASTNode * valueToCast, const std::string & type);
     
     /* New operator, which creates a new object on heap */
-    AASTOperator * newObject(const std::string & type);
+    /* Objects of pooled classes are taken from their class' pool */
+    AASTNode * newObject(const std::string & type);
+    
+    /* Returns name of the function which releases memory of an object of given type     */
+    /* Objects which may come from a pool are released into their pool, others are freed */
+    std::string getDeallocator(const std::string & type);
+    
+    /* Creates an object on stack using a compound literal, vtable pointers are stored directly */
+    /* Used instead of new for objects which don't escape the current function                  */
+    AASTValue * stackObject(const std::string & type);
+    /* Returns a designated initializer which sets vtables of an object and it's attributes */
+    std::string vtableInitializerList(const std::string & type);
     
     /* Deletes an object by calling destructor and deallocating memory              */
     /* Returns a scope which calls object's destructor, frees it's allocated memory */
     /* and sets object pointer to NULL                                              */
     /* Not all steps are always possible when deleting objects                      */
     /* deleteObjects() only handles these steps if they're possible to perform      */
-    AASTScope * deleteObject(AASTNode * object);
+    /* Objects allocated on stack are only destructed                               */
+    /* Elements of heap arrays are only freed                                       */
+    AASTScope * deleteObject(AASTNode * object, bool onStack = false, bool isArray = false);
     
     /* Copies the value of an object into a variable while preserving vtable pointers   */
     /* Vtable pointers need to be preserved in case someone assigns a value of object's */
     /* superclass instance while the object was passed polymorphically as an instance   */
     /* of it's superclass                                                               */
-    /* Copies contents of an object using memcpy                                        */
+    /* Copies contents of an object using the per-class copy function                   */
     AASTFuncall * copyObject(AASTNode * lvalue, AASTNode * rvalue);
     
     /* Checks if value is assignable (variable), throws exception on values which are */
     /* unassignable, eg. literals, function calls                                     */
     void checkIsAssignable(AASTNode * value);
+    /* Checks that value isn't a const variable, or an element of a const pointer or vector          */
+    /* Const pointers can be reassigned, only values they point to are constant (throughPointer)     */
+    void checkIsWritable(AASTNode * value, bool throughPointer);
+    /* Checks if value is a pointer to constant data, eg. a const pointer or the address of a constant */
+    bool pointsToConst(AASTNode * value);
+    /* Pointers to constant data can only be assigned to const pointers, description names the target */
+    void checkConstIsKept(AASTNode * value, bool targetIsConst, const std::string & description);
+    /* Checks that call of a function doesn't pass pointers to constant data to non-const parameters */
+    void checkConstArguments(const std::string & function,
+                             const std::string & mangledName,
+                             const std::vector<AASTNode *> & params);
+    /* Iterations of parallel loops run in parallel, so they may only write variables declared inside   */
+    /* the loop, reduction variables and memory accessed through pointers and arrays                    */
+    void checkParallelWrite(AASTNode * value, bool throughPointer);
+    /* Checks that return and break don't jump out of a parallel loop */
+    void checkParallelJump(const std::string & jump);
+    /* Checks that reduction variables of a parallel loop are numerical variables declared outside of it */
+    void checkReductions(ASTConstruct & construct);
+    
+    /* Returns qualifiers of a variable accessed from scope */
+    type_qualifiers getQualifiers(const std::string & name, ASTScope * scope);
+    /* Checks if qualifiers can be applied to a variable of type, restrict can only qualify pointers */
+    void checkQualifiers(const std::string & name, const std::string & type, const type_qualifiers & qualifiers);
+    /* Checks if alignment set by :align isn't lower than the natural alignment of type */
+    void checkAlignment(const std::string & name, const std::string & type, const type_qualifiers & qualifiers);
     
     /* Analyzes a function call parameter */
     AASTNode * getFuncallParameter(ASTNode * node);
@@ -111,10 +206,80 @@ class Analyzer {
     AASTConstruct * analyzeIfWhile(ASTConstruct & construct);
     /* Else if different because it doesn't have a condition */
     AASTConstruct * analyzeElse(ASTConstruct & construct);
+    /* Counted loop (for (i begin end [step]) ...), the end bound is evaluated once before the loop, */
+    /* step must be a non-zero integer constant and loops with a negative step count down           */
+    AASTConstruct * analyzeFor(ASTConstruct & construct);
     
     /* Analyzes variable declarations, deduces type if possible */
     AASTDeclaration * analyzeDeclaration(ASTDeclaration & declaration);
     
+    /* Analyzes array declarations, elements of stack arrays are initialized by a designated  */
+    /* initializer, heap arrays are allocated using malloc() and initialized in a loop       */
+    AASTDeclaration * analyzeArrayDeclaration(ASTDeclaration & declaration);
+    
+    /* Arrays declared in each scope, used to compute their size */
+    std::unordered_map<ASTScope *, std::unordered_map<std::string, ASTDeclaration *>> _arrays;
+    /* Returns declaration of an array accessed from scope, nullptr if variable isn't an array */
+    ASTDeclaration * getArray(const std::string & name, ASTScope * scope);
+    
+    /* Struct-of-arrays container, columns are allocated on heap and freed by (delete container) */
+    AASTDeclaration * analyzeSoaDeclaration(ASTDeclaration & declaration);
+    /* [container index attribute] accesses a column, [container length] the number of elements */
+    AASTValue soaAccess(ASTMemberAccess & attribute, const std::string & name, const std::string & type);
+    /* Frees all columns of a container */
+    AASTScope * deleteSoa(AASTNode * container);
+    /* Makes sure container type is defined, if type is a struct-of-arrays container or a pointer to one */
+    void useSoa(const std::string & type);
+    
+    /* Indexing operator (at array index), also accesses lanes of vectors */
+    AASTOperator * index(std::vector<AASTNode *> & params);
+    
+    /* Vector builtins, (vec_load f64x4 ptr), (vec_store ptr v), (vec_splat f64x4 x), */
+    /* (vec_shuffle a [b] indices...) and (vec_reduce_add/min/max v)                  */
+    AASTFuncall * vectorBuiltin(ASTFunCall & funcall);
+    /* Returns vector type passed as the first parameter of vec_load and vec_splat */
+    std::string vectorTypeParameter(ASTFunCall & funcall);
+    /* Checks if pointer points to memory which can hold elements of vector type */
+    void checkVectorPointer(AASTNode * pointer, const std::string & vectorType, const std::string & builtin);
+    
+    /* Hint and bit manipulation builtins, (likely cond), (unlikely cond), (prefetch ptr [rw [locality]]), */
+    /* (popcount x), (clz x), (ctz x), (bswap x) and (assume_aligned ptr alignment)                        */
+    AASTNode * hintBuiltin(const std::string & name, std::vector<AASTNode *> & params);
+    /* Checks if node is an integer literal and parses it's value */
+    bool integerConstant(const AASTNode * node, long long & value);
+    
+    /* Atomic operations, (atomic_load var [order]), (atomic_store var value [order]), (exchange var value [order]), */
+    /* (fetch_add/sub/and/or/xor var value [order]) and (cas/cas_weak var expected desired [success [failure]])     */
+    AASTFuncall * atomicBuiltin(ASTFunCall & funcall);
+    /* Returns C memory order passed as parameter, or memory_order_seq_cst if the parameter is nullptr */
+    std::string memoryOrder(ASTNode * order, const std::string & builtin);
+    
+    /* (spawn [result] (function params...)) runs a function as a task, which may be stolen by another worker */
+    /* Parameters are evaluated immediately, the result is stored in the variable once the task finishes     */
+    AASTFuncall * spawn(ASTFunCall & funcall);
+    /* (sync) waits until all tasks spawned by the current function finish, the waiting worker runs tasks meanwhile */
+    AASTFuncall * sync(ASTFunCall & funcall);
+    
+    /* (await (function params...)) creates a coroutine and suspends until it finishes, returns it's value */
+    /* (await coroutine) suspends until an existing coroutine finishes                                   */
+    AASTNode * await(ASTFunCall & funcall);
+    /* (yield) suspends the current coroutine, it continues when it's resumed */
+    AASTScope * yield(ASTFunCall & funcall);
+    /* Returns await, which may be analyzed as a part of statement, nullptr if statement can't contain await */
+    ASTFunCall * statementAwait(ASTNode * statement);
+    /* Checks if the current function can suspend at this point, it must be async and outside parallel loops */
+    void checkSuspension(const std::string & name);
+    /* Saves visible variables, suspends, and restores variables when the coroutine is resumed */
+    std::vector<AASTNode *> suspend();
+    /* Returns variables visible at a suspension point */
+    std::vector<parameter> visibleVariables();
+    /* Adds a variable of the current async function, which may be saved into it's frame */
+    void declareCoroutineVariable(const parameter & variable, ASTScope * scope, bool isStackArray = false);
+    /* Returns name of the frame field of a variable, fields are added when they're first used */
+    std::string frameField(const parameter & variable);
+    /* Records that address of a local variable of an async function is taken, referenced is the operand of & */
+    void addressOfCoroutineVariable(AASTNode * referenced);
+    
     AASTFuncall * getInitializer(ASTInitializer & initializer);
     
     AASTValue analyzeMemberAccess(ASTMemberAccess & attribute);
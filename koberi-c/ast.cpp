@@ -21,10 +21,13 @@ void AbstractSyntaxTree::checkType(const std::string & type) {
         t.pop_back();
     }
     
-    if (contains(_dataTypes, t)) {
-        return;
+    if (not contains(_dataTypes, t)) {
+        throw bad_type("Error: Unknown type: " + t);
+    }
+    
+    if (syntax::vectorTypes.count(t)) {
+        _usesVectors = true;
     }
-    throw bad_type("Error: Unknown type: " + t);
     
 }
 
@@ -91,7 +94,8 @@ void AbstractSyntaxTree::addMethod(const std::string & methodType, const std::st
 void AbstractSyntaxTree::emplaceFunction(const std::string & functionName,
                                          const std::string & returnType,
                                          const std::vector<parameter> & params,
-                                         const std::string & className) {
+                                         const std::string & className,
+                                         const Options & options) {
     
     /* Functions must be defined in the global scope in C */
     if (_currentScope != &_globalScope) {
@@ -115,7 +119,15 @@ void AbstractSyntaxTree::emplaceFunction(const std::string & functionName,
     }
     _functions[mangledName] = returnType;
     
-    ASTFunction * function = new ASTFunction(&_globalScope, functionName, returnType, params, className);
+    if (options.count("async")) {
+        _asyncFunctions.emplace(mangledName);
+    }
+    
+    for (const auto & param : params) {
+        _parameterQualifiers[mangledName].emplace_back(param.qualifiers);
+    }
+    
+    ASTFunction * function = new ASTFunction(&_globalScope, functionName, returnType, params, className, options);
     
     _globalScope.childNodes.emplace_back(function);
     
@@ -131,14 +143,23 @@ void AbstractSyntaxTree::emplaceFunction(const std::string & functionName,
         _currentScope->vars[param.name] = param.type;
         // _currentScope->vars.emplace(param.name, param.type);
         
+        if (param.qualifiers.isConst or param.qualifiers.isRestrict or param.qualifiers.isAtomic) {
+            _currentScope->qualifiers[param.name] = param.qualifiers;
+        }
+        
     }
     
 }
 
 void AbstractSyntaxTree::emplaceConstruct(const std::string & construct,
-                                          ASTNode * condition) {
+                                          ASTNode * condition,
+                                          const Options & options) {
 
-    ASTConstruct * constructPtr = new ASTConstruct(_currentScope, construct, condition);
+    ASTConstruct * constructPtr = new ASTConstruct(_currentScope, construct, condition, options);
+    
+    if (construct == "pfor") {
+        _usesOpenMP = true;
+    }
     
     _currentScope -> childNodes.emplace_back(constructPtr);
     
@@ -146,6 +167,46 @@ void AbstractSyntaxTree::emplaceConstruct(const std::string & construct,
 
 }
 
+bool AbstractSyntaxTree::usesOpenMP() const {
+    return _usesOpenMP;
+}
+
+bool AbstractSyntaxTree::usesAtomics() const {
+    return _usesAtomics;
+}
+
+bool AbstractSyntaxTree::usesVectors() const {
+    return _usesVectors;
+}
+
+void AbstractSyntaxTree::setUsesVectors() {
+    _usesVectors = true;
+}
+
+bool AbstractSyntaxTree::usesBitCounts() const {
+    return _usesBitCounts;
+}
+
+void AbstractSyntaxTree::setUsesBitCounts() {
+    _usesBitCounts = true;
+}
+
+bool AbstractSyntaxTree::isAsyncFunction(const std::string & mangledName) const {
+    return _asyncFunctions.count(mangledName);
+}
+
+const std::vector<type_qualifiers> & AbstractSyntaxTree::getParameterQualifiers(const std::string & mangledName) const {
+    
+    static const std::vector<type_qualifiers> none;
+    
+    if (not _parameterQualifiers.count(mangledName)) {
+        return none;
+    }
+    
+    return _parameterQualifiers.at(mangledName);
+    
+}
+
 void AbstractSyntaxTree::emplaceFunCall(const std::string & name,
                                         const std::vector<ASTNode *> & params) {
     
@@ -165,11 +226,13 @@ void AbstractSyntaxTree::emplaceFunCall(const ASTFunCall & fcall) {
 
 void AbstractSyntaxTree::emplaceDeclaration(const std::string & type,
                                             const std::string & name,
-                                            ASTNode * value) {
+                                            ASTNode * value,
+                                            const type_qualifiers & qualifiers) {
     
     checkType(type);
     
     ASTDeclaration * declaration = new ASTDeclaration(_currentScope, type, name, value);
+    declaration->qualifiers = qualifiers;
     _currentScope -> childNodes.emplace_back(declaration);
     
     /* Check if variable doesn't already exist */
@@ -179,6 +242,38 @@ void AbstractSyntaxTree::emplaceDeclaration(const std::string & type,
     
     _currentScope->vars[name] = type;
     
+    if (qualifiers.isConst or qualifiers.isRestrict or qualifiers.isAtomic) {
+        _currentScope->qualifiers[name] = qualifiers;
+    }
+    
+    if (qualifiers.isAtomic) {
+        _usesAtomics = true;
+    }
+    
+}
+
+void AbstractSyntaxTree::emplaceArrayDeclaration(const std::string & type,
+                                                 const std::string & name,
+                                                 ASTNode * length,
+                                                 bool onHeap) {
+    
+    emplaceDeclaration(syntax::pointerForType(type), name, nullptr);
+    
+    ASTDeclaration * declaration = (ASTDeclaration *)_currentScope->childNodes.back();
+    declaration->length = length;
+    declaration->onHeap = onHeap;
+    
+}
+
+void AbstractSyntaxTree::emplaceSoaDeclaration(const std::string & className,
+                                               const std::string & name,
+                                               ASTNode * length) {
+    
+    emplaceDeclaration(className + syntax::soaSuffix, name, nullptr);
+    
+    ASTDeclaration * declaration = (ASTDeclaration *)_currentScope->childNodes.back();
+    declaration->length = length;
+    
 }
 
 void AbstractSyntaxTree::emplaceInitializerCall(const std::string & varName) {
@@ -193,6 +288,9 @@ void AbstractSyntaxTree::addClassAttribute(const parameter & attribute, const st
 
     addClassAttribute(attribute.type, attribute.name, className);
     
+    /* Alignment set by :align is kept with the attribute */
+    _classes.at(className).attributes.back().qualifiers = attribute.qualifiers;
+    
 }
 
 void AbstractSyntaxTree::addClassAttribute(const std::string & type, const std::string & name, const std::string & className) {
@@ -223,7 +321,8 @@ void AbstractSyntaxTree::addClassAttribute(const std::string & type, const std::
 }
 
 void AbstractSyntaxTree::emplaceClass(const std::string & className,
-                                      const std::string & superClass) {
+                                      const std::string & superClass,
+                                      const Options & options) {
 
     /* Structs can be defined in local scopes in C, but functions can't    */
     /* This would make implementing methods difficult, so I'm only going   */
@@ -256,8 +355,18 @@ void AbstractSyntaxTree::emplaceClass(const std::string & className,
     
     c.className = className;
     c.superClass = superClass;
+    c.options = options;
 
+    /* Every class can be stored in a struct-of-arrays container */
+    const std::string soaType = className + syntax::soaSuffix;
+    
+    if (contains(_dataTypes, soaType)) {
+        throw redefinition_of_class(soaType);
+    }
+    
     _dataTypes.emplace_back(className);
+    _dataTypes.emplace_back(soaType);
+    _soaTypes.emplace(soaType, className);
     _classOrder.emplace_back(className);
     _classes.emplace(className, c);
 
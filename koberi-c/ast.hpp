@@ -11,6 +11,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "ast_node.hpp"
@@ -18,6 +19,7 @@
 #include "class.hpp"
 #include "contains.hpp"
 #include "name_mangler.hpp"
+#include "syntax.hpp"
 
 /* Class AbstractSyntaxTree, which holds parsed code                 */
 /* AbstractSyntaxTree is meant to create the tree and hold the data  */
@@ -34,9 +36,15 @@ protected:
     std::unordered_map<std::string, std::string> _functions;
     
     /* Keeps track of all data types, whether native types or user defined types */
-    std::vector<std::string> _dataTypes = { "num", "int", "uint", "char", "uchar", "void", "var" };
+    std::vector<std::string> _dataTypes = { "num", "int", "uint", "char", "uchar", "void", "var",
+        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64",
+        "f32x4", "f32x8", "f64x2", "f64x4", "i32x4", "i32x8", "i64x2", "i64x4", "u32x4", "u32x8", "i16x8", "u8x16",
+        "coroutine" };
     
-    const std::vector<std::string> _primitiveTypes = { "num", "int", "uint", "char", "uchar", "void" };
+    const std::vector<std::string> _primitiveTypes = { "num", "int", "uint", "char", "uchar", "void",
+        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64",
+        "f32x4", "f32x8", "f64x2", "f64x4", "i32x4", "i32x8", "i64x2", "i64x4", "u32x4", "u32x8", "i16x8", "u8x16",
+        "coroutine" };
     
     /* Checks if said type exists, if not, throws exception */
     /* If a pointer type is passes to this method,          */
@@ -45,6 +53,8 @@ protected:
     
     /* Stores classes */
     std::unordered_map<std::string, _class> _classes;
+    /* Struct-of-arrays container types and classes they contain */
+    std::unordered_map<std::string /* container */, std::string /* class */> _soaTypes;
     /* Keeps classes ordered in the order they were defined                                                      */
     /* This is necessary because C doesn't allow declaration of variables of incomplete (forward declared) types */
     /* Another option would be storing the classes in an ordered collection(vector, ast global scope nodes)      */
@@ -57,6 +67,22 @@ protected:
     /* Could be an std::reference_wrapper, but that would probably create even more cluttered code than a pointer */
     ASTScope * _currentScope;
     
+    /* Parallel loops are lowered to OpenMP, which requires <omp.h> */
+    bool _usesOpenMP = false;
+    /* Atomic variables are declared and accessed using <stdatomic.h> */
+    bool _usesAtomics = false;
+    /* SIMD vector typedefs and macros are only emitted for programs which use vector types */
+    bool _usesVectors = false;
+    /* Helpers implementing clz and ctz are only emitted for programs which count bits */
+    bool _usesBitCounts = false;
+    
+    /* Mangled names of async functions, calls of async functions create coroutines */
+    std::unordered_set<std::string> _asyncFunctions;
+    
+    /* Qualifiers of parameters of functions and methods, calls can't pass pointers to constants to non-const */
+    /* parameters                                                                                               */
+    std::unordered_map<std::string /* mangled name */, std::vector<type_qualifiers>> _parameterQualifiers;
+    
     
 public:
     AbstractSyntaxTree();
@@ -73,16 +99,42 @@ public:
     void addClassAttribute(const parameter & attribute, const std::string & className);
     void addClassAttribute(const std::string & type, const std::string & name, const std::string & className);
     
+    /* Struct-of-arrays containers are declared with the number of their elements */
+    void emplaceSoaDeclaration(const std::string & className,
+                               const std::string & name,
+                               ASTNode * length);
+    
+    /* Arrays are stored in scope as pointers to their elements */
+    void emplaceArrayDeclaration(const std::string & type,
+                                 const std::string & name,
+                                 ASTNode * length,
+                                 bool onHeap);
+    
     void emplaceFunction(const std::string & functionName,
                          const std::string & returnType,
                          const std::vector<parameter> & params,
-                         const std::string & className);
+                         const std::string & className,
+                         const Options & options = Options());
     
     void emplaceConstruct(const std::string & construct,
-                          ASTNode * condition);
+                          ASTNode * condition,
+                          const Options & options = Options());
+    
+    bool usesOpenMP() const;
+    bool usesAtomics() const;
+    bool usesVectors() const;
+    /* Vector types named only in builtins, eg. (vec_splat f32x4 1.0), aren't declared, the analyzer marks them */
+    void setUsesVectors();
+    bool usesBitCounts() const;
+    void setUsesBitCounts();
+    
+    bool isAsyncFunction(const std::string & mangledName) const;
+    /* Returns qualifiers of parameters of a function, the vector is empty for unknown functions */
+    const std::vector<type_qualifiers> & getParameterQualifiers(const std::string & mangledName) const;
     
     void emplaceClass(const std::string & className,
-                      const std::string & superClass);
+                      const std::string & superClass,
+                      const Options & options = Options());
     
     void emplaceFunCall(const std::string & name,
                         const std::vector<ASTNode *> & params);
@@ -91,7 +143,8 @@ public:
     
     void emplaceDeclaration(const std::string & type,
                             const std::string & name,
-                            ASTNode * value = nullptr);
+                            ASTNode * value = nullptr,
+                            const type_qualifiers & qualifiers = type_qualifiers());
     
     void emplaceInitializerCall(const std::string & varName);
     
@@ -44,23 +44,27 @@ ASTFunction::ASTFunction(ASTScope * parent,
                          const std::string & functionName,
                          const std::string & returnType,
                          const std::vector<parameter> & params,
-                         const std::string & className) : ASTScope(parent) {
+                         const std::string & className,
+                         const Options & options) : ASTScope(parent) {
     
     nodeType    = NodeType::Function;
     name        = functionName;
     type        = returnType;
     parameters  = params;
     this->className = className;
+    this->options   = options;
     
 }
 
 ASTConstruct::ASTConstruct(ASTScope * parent,
                            const std::string & construct,
-                           ASTNode * newCondition) : ASTScope(parent) {
+                           ASTNode * newCondition,
+                           const Options & options) : ASTScope(parent) {
 
     nodeType = NodeType::Construct;
     this->construct = construct;
     this->condition = newCondition;
+    this->options = options;
     
 }
 
@@ -262,8 +266,11 @@ void ASTMemberAccess::check() {
     
     for (size_t i = 1; i < accessOrder.size(); ++i) {
         
-        type = (*accessOrder[i]).nodeType;
-        if (type != NodeType::Variable) {
+        /* Elements of struct-of-arrays containers are indexed, eg. [particles (+ i 1) x], analyzer checks the type */
+        const bool isIndex = i == 1 and type == NodeType::Variable and
+                             (accessOrder[i]->nodeType == NodeType::Literal or accessOrder[i]->nodeType == NodeType::FunCall);
+        
+        if (accessOrder[i]->nodeType != NodeType::Variable and not isIndex) {
             throw invalid_attribute_access("Parameters of [] operator beyond the first operator must be valid identifiers. ");
         }
         
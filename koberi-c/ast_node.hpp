@@ -12,8 +12,10 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <map>
 
 #include "parameter.hpp"
+#include "options.hpp"
 #include "exceptions.hpp"
 
 /* AbstractSyntaxTree nodes                         */
@@ -56,6 +58,8 @@ struct ASTScope : public ASTNode {
     /* Keeps track of variables for the current scope                                               */
     /* To access variables from parent scope, access parentScope.vars (apply recursively if needed) */
     std::unordered_map<std::string, std::string> vars;
+    /* Qualifiers of variables declared as const or restrict */
+    std::unordered_map<std::string, type_qualifiers> qualifiers;
     
     /* Pass in an ASTNode, not an ASTScope so the constructor isn't treated as a copy-constructor */
     ASTScope(ASTScope * parent);
@@ -149,12 +153,14 @@ struct ASTFunction : public ASTScope {
     std::string type;
     std::string className;
     std::vector<parameter> parameters;
+    Options options;
     
     ASTFunction(ASTScope * parent,
                 const std::string & functionName,
                 const std::string & returnType,
                 const std::vector<parameter> & params,
-                const std::string & className);
+                const std::string & className,
+                const Options & options = Options());
     
 };
 
@@ -164,10 +170,15 @@ struct ASTConstruct : public ASTScope {
     
     std::string construct;
     ASTNode * condition;
+    /* Loop hints, eg. :unroll 4, :vectorize and :ivdep */
+    Options options;
+    /* Variables combined across iterations of a parallel loop and their operators, eg. sum -> + */
+    std::map<std::string /* variable */, std::string /* operator */> reductions;
     
     ASTConstruct(ASTScope * parent,
                  const std::string & construct,
-                 ASTNode * condition);
+                 ASTNode * condition,
+                 const Options & options = Options());
     
     ~ASTConstruct();
     
@@ -179,6 +190,11 @@ struct ASTDeclaration : public ASTNode {
     std::string type;
     std::string name;
     ASTNode * value;
+    type_qualifiers qualifiers;
+    
+    /* Arrays are declared as pointers to their elements, length is nullptr for other variables */
+    ASTNode * length = nullptr;
+    bool onHeap = false;
     
     ASTDeclaration(ASTScope * parent,
                    const std::string & paramType,
@@ -16,6 +16,7 @@
 #include "parameter.hpp"
 #include "exceptions.hpp"
 #include "vtable.hpp"
+#include "options.hpp"
 
 /* Class struct                                                                           */
 /* Abstraction for Kobeři-C classes, all classes are stored as an instance of this struct */
@@ -35,6 +36,10 @@ struct _class {
     /* Holds vtable with all methods, including inherited methods */
     VTable vtable;
     
+    /* Options set using keywords in class definition, eg. :pool */
+    /* Options aren't inherited from superclasses                */
+    Options options;
+    
     std::string getVarType(const std::string & name) const;
     bool hasVar(const std::string & name) const;
     
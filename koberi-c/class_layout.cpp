@@ -0,0 +1,223 @@
+//
+//  class_layout.cpp
+//  koberi-c
+//
+
+#include "class_layout.hpp"
+
+ClassLayout::ClassLayout(TraversableAbstractSyntaxTree & ast) : _ast(ast) {
+    
+}
+
+size_t ClassLayout::typeSize(const std::string & type) {
+    
+    if (syntax::isPointerType(type)) {
+        return pointerSize;
+    }
+    
+    if (type == "char" or type == "uchar" or type == "i8" or type == "u8") {
+        return 1;
+    }
+    
+    if (type == "i16" or type == "u16") {
+        return 2;
+    }
+    
+    if (type == "i32" or type == "u32" or type == "f32") {
+        return 4;
+    }
+    
+    if (syntax::vectorTypes.count(type)) {
+        return syntax::vectorTypes.at(type).second * typeSize(syntax::vectorTypes.at(type).first);
+    }
+    
+    if (_layouts.count(type)) {
+        return _layouts.at(type).size;
+    }
+    
+    /* int, uint, num, i64, u64, f64 */
+    return 8;
+    
+}
+
+size_t ClassLayout::typeAlignment(const std::string & type) {
+    
+    if (_layouts.count(type)) {
+        return _layouts.at(type).alignment;
+    }
+    
+    /* Vectors are aligned to their size, other types are aligned to their size as well */
+    return typeSize(type);
+    
+}
+
+size_t ClassLayout::attributeAlignment(const parameter & attribute) {
+    
+    return std::max(typeAlignment(attribute.type), attribute.qualifiers.alignment);
+    
+}
+
+struct_layout ClassLayout::computeLayout(const std::vector<parameter> & attributes, size_t alignment) {
+    
+    struct_layout layout;
+    
+    /* Every struct starts with a vtable pointer */
+    size_t offset = pointerSize;
+    layout.alignment = pointerSize;
+    layout.alignment = std::max(layout.alignment, alignment);
+    
+    for (const parameter & attribute : attributes) {
+        
+        const size_t alignment = attributeAlignment(attribute);
+        const size_t padding = (alignment - offset % alignment) % alignment;
+        
+        layout.padding += padding;
+        layout.alignment = std::max(layout.alignment, alignment);
+        offset += padding + typeSize(attribute.type);
+        
+    }
+    
+    /* Arrays of structs keep every element aligned */
+    const size_t tail = (layout.alignment - offset % layout.alignment) % layout.alignment;
+    
+    layout.padding += tail;
+    layout.size = offset + tail;
+    
+    return layout;
+    
+}
+
+std::vector<parameter> ClassLayout::reorder(const std::vector<parameter> & inherited, std::vector<parameter> own) {
+    
+    std::vector<parameter> attributes = inherited;
+    
+    size_t offset = pointerSize;
+    
+    for (const parameter & attribute : inherited) {
+        
+        const size_t alignment = attributeAlignment(attribute);
+        offset += (alignment - offset % alignment) % alignment + typeSize(attribute.type);
+        
+    }
+    
+    while (not own.empty()) {
+        
+        size_t best = 0;
+        size_t bestPadding = SIZE_MAX;
+        
+        for (size_t i = 0; i < own.size(); ++i) {
+            
+            const size_t alignment = attributeAlignment(own[i]);
+            const size_t padding = (alignment - offset % alignment) % alignment;
+            
+            if (padding < bestPadding or (padding == bestPadding and alignment > attributeAlignment(own[best]))) {
+                best = i;
+                bestPadding = padding;
+            }
+            
+        }
+        
+        offset += bestPadding + typeSize(own[best].type);
+        
+        attributes.emplace_back(own[best]);
+        own.erase(own.begin() + best);
+        
+    }
+    
+    return attributes;
+    
+}
+
+std::vector<parameter> ClassLayout::arrange(const std::string & className,
+                                            const std::string & superClass,
+                                            const std::vector<parameter> & attributes,
+                                            bool reorderAttributes,
+                                            size_t alignment) {
+    
+    /* Inherited attributes come first, in the order the superclass emits them */
+    std::vector<parameter> inherited;
+    
+    if (superClass != "" and _attributes.count(superClass)) {
+        inherited = _attributes.at(superClass);
+        alignment = std::max(alignment, _layouts.at(superClass).alignment);
+    }
+    
+    std::vector<parameter> own(attributes.begin() + std::min(inherited.size(), attributes.size()), attributes.end());
+    
+    std::vector<parameter> arranged = reorder(inherited, own);
+    
+    if (not reorderAttributes) {
+        
+        _reorderedLayouts[className] = computeLayout(arranged, alignment);
+        
+        arranged = inherited;
+        arranged.insert(arranged.end(), own.begin(), own.end());
+        
+    }
+    
+    _layouts[className] = computeLayout(arranged, alignment);
+    _attributes[className] = arranged;
+    _classOrder.emplace_back(className);
+    
+    return arranged;
+    
+}
+
+size_t ClassLayout::maxCacheLines(const struct_layout & layout) {
+    
+    size_t lines = 0;
+    
+    /* Objects can start at any offset inside a cache line which respects their alignment */
+    for (size_t offset = 0; offset < cacheLineSize; offset += layout.alignment) {
+        lines = std::max(lines, (offset + layout.size + cacheLineSize - 1) / cacheLineSize);
+    }
+    
+    return lines;
+    
+}
+
+void ClassLayout::report(std::ostream & stream) {
+    
+    stream << "Class layouts:" << "\n\n";
+    
+    for (const std::string & className : _classOrder) {
+        
+        const struct_layout & layout = _layouts.at(className);
+        
+        const size_t minLines = (layout.size + cacheLineSize - 1) / cacheLineSize;
+        const size_t maxLines = maxCacheLines(layout);
+        
+        stream << className << ": " << layout.size << " bytes, " << layout.padding << " bytes of padding, "
+               << "alignment " << layout.alignment << ", spans " << minLines;
+        
+        if (maxLines != minLines) {
+            stream << "-" << maxLines;
+        }
+        
+        stream << (maxLines == 1 ? " cache line" : " cache lines");
+        
+        if (_reorderedLayouts.count(className) and _reorderedLayouts.at(className).size < layout.size) {
+            stream << " (:reorder saves " << layout.size - _reorderedLayouts.at(className).size << " bytes)";
+        }
+        
+        stream << "\n";
+        
+        /* Offsets of attributes, vtable pointer is at offset 0 */
+        size_t offset = pointerSize;
+        
+        for (const parameter & attribute : _attributes.at(className)) {
+            
+            const size_t alignment = attributeAlignment(attribute);
+            offset += (alignment - offset % alignment) % alignment;
+            
+            stream << "    " << offset << ": " << attribute.type << " " << attribute.name << "\n";
+            
+            offset += typeSize(attribute.type);
+            
+        }
+        
+    }
+    
+    stream << std::endl;
+    
+}
@@ -0,0 +1,85 @@
+//
+//  class_layout.hpp
+//  koberi-c
+//
+
+#ifndef class_layout_hpp
+#define class_layout_hpp
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+
+#include "traversable_ast.hpp"
+#include "parameter.hpp"
+#include "syntax.hpp"
+
+/* Size, alignment and padding of a generated struct, assumes a 64 bit target */
+
+struct struct_layout {
+    
+    size_t size = 0;
+    size_t alignment = 1;
+    size_t padding = 0;
+    
+};
+
+/* Computes layouts of classes, optionally reorders attributes to minimize padding          */
+/* Attributes of superclasses are never moved, casts to superclasses rely on the subclass */
+/* struct starting with the same attributes as the superclass struct                      */
+
+class ClassLayout {
+    
+    TraversableAbstractSyntaxTree & _ast;
+    
+    /* Attributes of each class in the order they're emitted in */
+    std::unordered_map<std::string, std::vector<parameter>> _attributes;
+    std::unordered_map<std::string, struct_layout> _layouts;
+    /* Layouts of classes without :reorder as they would be with reordered attributes */
+    std::unordered_map<std::string, struct_layout> _reorderedLayouts;
+    std::vector<std::string> _classOrder;
+    
+    static const size_t cacheLineSize = 64;
+    static const size_t pointerSize = 8;
+    
+    /* Returns size of an attribute of type */
+    size_t typeSize(const std::string & type);
+    /* Returns alignment of an attribute, including alignment set by :align */
+    size_t attributeAlignment(const parameter & attribute);
+    
+    /* Computes layout of a struct starting with a vtable pointer followed by attributes */
+    /* Struct is aligned at least to alignment                                           */
+    struct_layout computeLayout(const std::vector<parameter> & attributes, size_t alignment = 1);
+    
+    /* Appends attributes to inherited ones, each step picks the most aligned attribute */
+    /* which fits without padding, or the one which needs the least padding          */
+    std::vector<parameter> reorder(const std::vector<parameter> & inherited, std::vector<parameter> own);
+    
+    /* Returns the maximal number of cache lines an object with layout can span */
+    size_t maxCacheLines(const struct_layout & layout);
+    
+public:
+    
+    ClassLayout(TraversableAbstractSyntaxTree & ast);
+    
+    /* Returns attributes of class in the order they should be emitted in          */
+    /* Superclasses must be arranged before their subclasses                     */
+    /* Alignment set by :align is inherited by subclasses                        */
+    std::vector<parameter> arrange(const std::string & className,
+                                   const std::string & superClass,
+                                   const std::vector<parameter> & attributes,
+                                   bool reorderAttributes,
+                                   size_t alignment = 1);
+    
+    /* Returns natural alignment of type, classes must be arranged first */
+    size_t typeAlignment(const std::string & type);
+    
+    /* Prints size, padding and cache line footprint of all arranged classes */
+    void report(std::ostream & stream);
+    
+};
+
+#endif /* class_layout_hpp */
@@ -0,0 +1,348 @@
+//
+//  escape_analysis.cpp
+//  koberi-c
+//
+
+#include "escape_analysis.hpp"
+
+EscapeAnalysis::EscapeAnalysis(TraversableAbstractSyntaxTree & ast) : _ast(ast) {
+    
+}
+
+stack_allocations EscapeAnalysis::analyze(ASTFunction & function) {
+    
+    stack_allocations allocations;
+    
+    analyzeScope(function, allocations);
+    
+    return allocations;
+    
+}
+
+std::string EscapeAnalysis::allocatedClass(const ASTDeclaration & declaration) {
+    
+    if (declaration.value == nullptr or declaration.value->nodeType != NodeType::FunCall) {
+        return "";
+    }
+    
+    const ASTFunCall & fcall = *((ASTFunCall*)declaration.value);
+    
+    if (fcall.function != "new" or fcall.object != nullptr or fcall.parameters.size() != 1 or
+        fcall.parameters[0]->nodeType != NodeType::Variable) {
+        return "";
+    }
+    
+    const std::string & type = ((ASTVariable*)fcall.parameters[0])->name;
+    
+    if (syntax::isPointerType(type) or not _ast.isClass(type)) {
+        return "";
+    }
+    
+    return type;
+    
+}
+
+void EscapeAnalysis::analyzeScope(ASTScope & scope, stack_allocations & allocations) {
+    
+    const std::vector<ASTNode *> & nodes = scope.childNodes;
+    
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        
+        if (nodes[i]->nodeType == NodeType::Construct) {
+            analyzeScope(*((ASTConstruct*)nodes[i]), allocations);
+            continue;
+        }
+        
+        if (nodes[i]->nodeType == NodeType::Scope) {
+            analyzeScope(*((ASTScope*)nodes[i]), allocations);
+            continue;
+        }
+        
+        if (nodes[i]->nodeType != NodeType::Declaration) {
+            continue;
+        }
+        
+        ASTDeclaration * declaration = (ASTDeclaration*)nodes[i];
+        std::string className = allocatedClass(*declaration);
+        
+        if (className == "") {
+            continue;
+        }
+        
+        /* The object lives until the end of the scope, so only the rest of the scope needs to be checked */
+        std::unordered_set<ASTFunCall *> deletes;
+        
+        if (not escapesScope(nodes, i + 1, declaration->name, className, deletes)) {
+            
+            allocations.declarations.emplace(declaration);
+            allocations.deletes.insert(deletes.begin(), deletes.end());
+            
+        }
+        
+    }
+    
+}
+
+bool EscapeAnalysis::escapesScope(const std::vector<ASTNode *> & nodes,
+                                  size_t first,
+                                  const std::string & name,
+                                  const std::string & className,
+                                  std::unordered_set<ASTFunCall *> & deletes) {
+    
+    for (size_t i = first; i < nodes.size(); ++i) {
+        
+        if (escapes(nodes[i], name, className, deletes)) {
+            return true;
+        }
+        
+        /* Variable is shadowed, the rest of the scope doesn't use it */
+        if (nodes[i]->nodeType == NodeType::Declaration and ((ASTDeclaration*)nodes[i])->name == name) {
+            return false;
+        }
+        
+    }
+    
+    return false;
+    
+}
+
+bool EscapeAnalysis::escapes(ASTNode * node,
+                             const std::string & name,
+                             const std::string & className,
+                             std::unordered_set<ASTFunCall *> & deletes) {
+    
+    if (node == nullptr) {
+        return false;
+    }
+    
+    switch (node->nodeType) {
+        
+        /* Any use of the pointer itself lets it escape, eg. (return ptr), (set x ptr), (fun ptr) */
+        case NodeType::Variable:
+            return ((ASTVariable*)node)->name == name;
+        
+        case NodeType::Literal:
+        case NodeType::Initializer:
+            return false;
+        
+        case NodeType::Declaration:
+            return escapes(((ASTDeclaration*)node)->value, name, className, deletes);
+        
+        case NodeType::Construct: {
+            
+            ASTConstruct & construct = *((ASTConstruct*)node);
+            
+            if (escapes(construct.condition, name, className, deletes)) {
+                return true;
+            }
+            
+            return escapesScope(construct.childNodes, 0, name, className, deletes);
+        }
+        
+        case NodeType::Scope:
+            return escapesScope(((ASTScope*)node)->childNodes, 0, name, className, deletes);
+        
+        case NodeType::MemberAccess: {
+            
+            ASTMemberAccess & access = *((ASTMemberAccess*)node);
+            
+            if (access.accessOrder.empty()) {
+                return false;
+            }
+            
+            /* Only the first element can be a variable, the rest are attribute names */
+            ASTNode * base = access.accessOrder[0];
+            
+            if (base->nodeType == NodeType::Variable and ((ASTVariable*)base)->name == name) {
+                /* [ptr attribute] only reads or writes an attribute */
+                return access.accessOrder.size() < 2;
+            }
+            
+            return escapes(base, name, className, deletes);
+        }
+        
+        case NodeType::FunCall: {
+            
+            ASTFunCall & fcall = *((ASTFunCall*)node);
+            
+            if (fcall.object == nullptr) {
+                
+                /* Delete of the object itself, destructor mustn't leak self */
+                if (fcall.function == "delete" and fcall.parameters.size() == 1 and
+                    fcall.parameters[0]->nodeType == NodeType::Variable and
+                    ((ASTVariable*)fcall.parameters[0])->name == name) {
+                    
+                    if (leaksSelf("destruct", className)) {
+                        return true;
+                    }
+                    
+                    deletes.emplace(&fcall);
+                    return false;
+                }
+                
+                /* Addresses of attributes point into the object, inline C can do anything */
+                if (fcall.function == "&" or fcall.function == "_c") {
+                    
+                    for (ASTNode * param : fcall.parameters) {
+                        if (mentions(param, name)) {
+                            return true;
+                        }
+                    }
+                    
+                    return false;
+                }
+                
+            } else {
+                
+                const std::vector<ASTNode *> & order = fcall.object->accessOrder;
+                
+                if (not order.empty() and order[0]->nodeType == NodeType::Variable and
+                    ((ASTVariable*)order[0])->name == name) {
+                    
+                    /* Methods called on attributes get a pointer into the object */
+                    if (order.size() > 1 or leaksSelf(fcall.function, className)) {
+                        return true;
+                    }
+                    
+                } else if (escapes(fcall.object, name, className, deletes)) {
+                    return true;
+                }
+                
+            }
+            
+            for (ASTNode * param : fcall.parameters) {
+                if (escapes(param, name, className, deletes)) {
+                    return true;
+                }
+            }
+            
+            return false;
+        }
+        
+        default:
+            return true;
+        
+    }
+    
+}
+
+bool EscapeAnalysis::mentions(ASTNode * node, const std::string & name) {
+    
+    if (node == nullptr) {
+        return false;
+    }
+    
+    switch (node->nodeType) {
+        
+        case NodeType::Variable:
+            return ((ASTVariable*)node)->name == name;
+        
+        case NodeType::Literal: {
+            
+            /* Look for the name as a whole identifier in inline C */
+            const std::string & value = ((ASTLiteral*)node)->value;
+            
+            for (size_t pos = value.find(name); pos != std::string::npos; pos = value.find(name, pos + 1)) {
+                
+                size_t end = pos + name.size();
+                
+                bool startsId = pos == 0 or not (syntax::isValidIdChar(value[pos - 1]) or
+                                                 syntax::isNum(value[pos - 1]));
+                bool endsId = end == value.size() or not (syntax::isValidIdChar(value[end]) or
+                                                          syntax::isNum(value[end]));
+                
+                if (startsId and endsId) {
+                    return true;
+                }
+                
+            }
+            
+            return false;
+        }
+        
+        case NodeType::MemberAccess: {
+            
+            const std::vector<ASTNode *> & order = ((ASTMemberAccess*)node)->accessOrder;
+            return not order.empty() and mentions(order[0], name);
+        }
+        
+        case NodeType::FunCall: {
+            
+            ASTFunCall & fcall = *((ASTFunCall*)node);
+            
+            if (mentions(fcall.object, name)) {
+                return true;
+            }
+            
+            for (ASTNode * param : fcall.parameters) {
+                if (mentions(param, name)) {
+                    return true;
+                }
+            }
+            
+            return false;
+        }
+        
+        default:
+            return false;
+        
+    }
+    
+}
+
+bool EscapeAnalysis::leaksSelf(const std::string & methodName, const std::string & className) {
+    
+    const std::string key = methodName + " " + className;
+    
+    if (_leakingMethods.count(key)) {
+        return _leakingMethods.at(key);
+    }
+    
+    /* Recursive calls assume the method doesn't leak self, any other use is checked normally */
+    _leakingMethods[key] = false;
+    
+    /* Check all overloads of the method in the class and it's superclasses */
+    std::unordered_set<std::string> classes;
+    
+    for (std::string c = className; c != ""; c = _ast.getClass(c).superClass) {
+        classes.emplace(c);
+    }
+    
+    bool leaks = false;
+    bool found = false;
+    
+    ASTScope & global = _ast.getGlobalScope();
+    
+    for (ASTNode * node : global.childNodes) {
+        
+        if (node->nodeType != NodeType::Function) {
+            continue;
+        }
+        
+        ASTFunction & function = *((ASTFunction*)node);
+        
+        if (function.name != methodName or not classes.count(function.className)) {
+            continue;
+        }
+        
+        found = true;
+        
+        std::unordered_set<ASTFunCall *> deletes;
+        
+        if (escapesScope(function.childNodes, 0, "self", className, deletes) or not deletes.empty()) {
+            leaks = true;
+            break;
+        }
+        
+    }
+    
+    /* Destructors are optional, unknown methods are assumed to leak self */
+    if (not found and methodName != "destruct") {
+        leaks = true;
+    }
+    
+    _leakingMethods[key] = leaks;
+    
+    return leaks;
+    
+}
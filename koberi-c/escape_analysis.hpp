@@ -0,0 +1,69 @@
+//
+//  escape_analysis.hpp
+//  koberi-c
+//
+
+#ifndef escape_analysis_hpp
+#define escape_analysis_hpp
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "traversable_ast.hpp"
+#include "syntax.hpp"
+
+/* Objects created by new, which never leave the function they were created in */
+/* Declarations are lowered to stack objects, matching deletes only destruct     */
+
+struct stack_allocations {
+    
+    std::unordered_set<ASTDeclaration *> declarations;
+    std::unordered_set<ASTFunCall *> deletes;
+    
+};
+
+/* Finds pointers initialized using (new Class), which don't escape their function   */
+/* A pointer escapes if it's used in any other way than accessing object attributes, */
+/* calling methods which don't leak self or deleting the object                      */
+/* Eg. returning the pointer, storing it, passing it to a function or taking it's    */
+/* address makes the pointer escape                                                  */
+
+class EscapeAnalysis {
+    
+    TraversableAbstractSyntaxTree & _ast;
+    
+    /* Memoized results of leaksSelf(), key is method name and class name */
+    std::unordered_map<std::string, bool> _leakingMethods;
+    
+    /* Checks if any use of variable name inside node makes the variable escape     */
+    /* Deletes of the variable are stored in deletes, className is the object class */
+    bool escapes(ASTNode * node, const std::string & name, const std::string & className,
+                 std::unordered_set<ASTFunCall *> & deletes);
+    
+    /* Checks nodes of a scope, stops when variable gets shadowed by a declaration */
+    bool escapesScope(const std::vector<ASTNode *> & nodes, size_t first, const std::string & name,
+                      const std::string & className, std::unordered_set<ASTFunCall *> & deletes);
+    
+    /* Checks if node mentions variable in any way */
+    bool mentions(ASTNode * node, const std::string & name);
+    
+    /* Checks if any method with given name callable on an instance of className may leak self */
+    bool leaksSelf(const std::string & methodName, const std::string & className);
+    
+    /* Finds candidate declarations (Class* ptr (new Class)) in a scope and nested scopes */
+    void analyzeScope(ASTScope & scope, stack_allocations & allocations);
+    
+    /* Returns class name if declaration is initialized with (new Class), empty string otherwise */
+    std::string allocatedClass(const ASTDeclaration & declaration);
+
+public:
+    
+    EscapeAnalysis(TraversableAbstractSyntaxTree & ast);
+    
+    /* Returns allocations which can be safely moved to stack and their deletes */
+    stack_allocations analyze(ASTFunction & function);
+    
+};
+
+#endif /* escape_analysis_hpp */
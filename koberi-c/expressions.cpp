@@ -12,6 +12,13 @@ namespace expr {
     /* Variable is_verbose needs to be be inaccessible from outside      */
     /* If it were defined in a header file, it would cause linker errors */
     bool is_verbose = false;
+    bool pool_allocation = false;
+    bool pool_stats = false;
+    bool reorder_attributes = false;
+    bool layout_report = false;
+    bool instrument = false;
+    std::string profile_use;
+    std::string std_lib_path;
 }
 
 void expr::setVerbose(bool value) {
@@ -22,12 +29,116 @@ bool expr::isVerbose() {
     return expr::is_verbose;
 }
 
+void expr::setPoolAllocation(bool value) {
+    expr::pool_allocation = value;
+}
+
+bool expr::isPoolAllocation() {
+    return expr::pool_allocation;
+}
+
+void expr::setPoolStats(bool value) {
+    expr::pool_stats = value;
+}
+
+bool expr::isPoolStats() {
+    return expr::pool_stats;
+}
+
+void expr::setReorderAttributes(bool value) {
+    expr::reorder_attributes = value;
+}
+
+bool expr::isReorderAttributes() {
+    return expr::reorder_attributes;
+}
+
+void expr::setLayoutReport(bool value) {
+    expr::layout_report = value;
+}
+
+bool expr::isLayoutReport() {
+    return expr::layout_report;
+}
+
+void expr::setInstrument(bool value) {
+    expr::instrument = value;
+}
+
+bool expr::isInstrument() {
+    return expr::instrument;
+}
+
+void expr::setProfileUse(const std::string & filename) {
+    expr::profile_use = filename;
+}
+
+const std::string & expr::getProfileUse() {
+    return expr::profile_use;
+}
+
+void expr::setStdLibPath(const std::string & path) {
+    expr::std_lib_path = path;
+}
+
+const std::string & expr::getStdLibPath() {
+    return expr::std_lib_path;
+}
+
 bool expr::isConstruct(const std::string & construct) {
     
     return contains(constructs, construct);
     
 }
 
+bool expr::isReductionOperator(const std::string & op) {
+    
+    return contains(reduction_operators, op);
+    
+}
+
+bool expr::isQualifier(const std::string & qualifier) {
+    
+    return contains(qualifiers, qualifier);
+    
+}
+
+bool expr::isClassOption(const std::string & option) {
+    
+    return contains(class_options, option);
+    
+}
+
+bool expr::isFunctionOption(const std::string & option) {
+    
+    return contains(function_options, option);
+    
+}
+
+bool expr::isArrayOption(const std::string & option) {
+    
+    return contains(array_options, option);
+    
+}
+
+bool expr::isVariableOption(const std::string & option) {
+    
+    return contains(variable_options, option);
+    
+}
+
+bool expr::isLoopOption(const std::string & option) {
+    
+    return contains(loop_options, option);
+    
+}
+
+bool expr::isValuedOption(const std::string & option) {
+    
+    return contains(valued_options, option);
+    
+}
+
 bool expr::isOperator(const std::string & op) {
     
     return contains(operators, op);
@@ -58,6 +169,174 @@ bool expr::isNumericalType(const std::string & type) {
     
 }
 
+bool expr::isSignedType(const std::string & type) {
+    
+    return contains(signed_types, type);
+    
+}
+
+bool expr::isUnsignedType(const std::string & type) {
+    
+    return contains(unsigned_types, type);
+    
+}
+
+bool expr::isFloatingType(const std::string & type) {
+    
+    return contains(floating_types, type);
+    
+}
+
+bool expr::isVectorType(const std::string & type) {
+    
+    return syntax::vectorTypes.count(type);
+    
+}
+
+std::string expr::vectorElementType(const std::string & type) {
+    
+    return syntax::vectorTypes.at(type).first;
+    
+}
+
+int expr::vectorLanes(const std::string & type) {
+    
+    return syntax::vectorTypes.at(type).second;
+    
+}
+
+bool expr::isVectorBuiltin(const std::string & name) {
+    
+    return contains(vector_builtins, name);
+    
+}
+
+bool expr::isHintBuiltin(const std::string & name) {
+    
+    return contains(hint_builtins, name);
+    
+}
+
+bool expr::isAtomicBuiltin(const std::string & name) {
+    
+    return contains(atomic_builtins, name);
+    
+}
+
+bool expr::isMemoryOrder(const std::string & order) {
+    
+    return contains(memory_orders, order);
+    
+}
+
+std::string expr::arithmeticType(const std::vector<AASTNode *> & params) {
+    
+    std::string type = params[0]->type();
+    
+    /* Pointer arithmetic results in a pointer */
+    if (not isNumericalType(type)) {
+        return type;
+    }
+    
+    for (AASTNode * param : params) {
+        
+        const std::string & paramType = param->type();
+        
+        if (not isFloatingType(paramType)) {
+            continue;
+        }
+        
+        if (not isFloatingType(type) or (type == "f32" and paramType != "f32")) {
+            type = paramType;
+        }
+        
+    }
+    
+    if (isFloatingType(type)) {
+        return type;
+    }
+    
+    /* Integers are converted to the widest operand, unsigned types win over signed types of the same width */
+    for (AASTNode * param : params) {
+        
+        const std::string & paramType = param->type();
+        
+        if (not isNumericalType(paramType)) {
+            continue;
+        }
+        
+        const int width = integerWidth(type);
+        const int paramWidth = integerWidth(paramType);
+        
+        if (paramWidth > width or (paramWidth == width and isUnsigned(paramType) and not isUnsigned(type))) {
+            type = paramType;
+        }
+        
+    }
+    
+    return type;
+    
+}
+
+int expr::integerWidth(const std::string & type) {
+    
+    if (type == "i32" or type == "u32") {
+        return 32;
+    }
+    
+    if (type == "i16" or type == "u16") {
+        return 16;
+    }
+    
+    if (type == "i8" or type == "u8" or type == "char" or type == "uchar") {
+        return 8;
+    }
+    
+    return 64;
+    
+}
+
+bool expr::isUnsigned(const std::string & type) {
+    
+    return isUnsignedType(type) or type == "uchar";
+    
+}
+
+bool expr::hasSideEffects(AASTNode * node) {
+    
+    if (node->nodeType() == AASTNodeType::Value) {
+        return false;
+    }
+    
+    if (node->nodeType() == AASTNodeType::Cast) {
+        return hasSideEffects(((AASTCast *)node)->getValue());
+    }
+    
+    if (node->nodeType() != AASTNodeType::Operator) {
+        return true;
+    }
+    
+    AASTOperator * op = (AASTOperator *)node;
+    
+    if (contains(side_effect_operators, op->getOperator())) {
+        return true;
+    }
+    
+    /* Operand of sizeof isn't evaluated */
+    if (op->getOperator() == "sizeof") {
+        return false;
+    }
+    
+    for (AASTNode * param : op->getParameters()) {
+        if (hasSideEffects(param)) {
+            return true;
+        }
+    }
+    
+    return false;
+    
+}
+
 AASTNode * expr::dereferencePtr(AASTNode * param) {
     
     /* Derefence pointer if param is a pointer and address isn't accessed explicitely */
@@ -84,6 +363,13 @@ AASTOperator * expr::mod(std::vector<AASTNode *> & params) {
         node = dereferencePtr(node);
     }
     
+    /* Integer vectors are divided element-wise */
+    for (AASTNode * node : params) {
+        if (isVectorType(node->type())) {
+            return vectorOperator(params, "mod");
+        }
+    }
+    
     /* If at least one of the parameters is a floating point number, call fmod() */
     for (auto & param : params) {
         
@@ -92,13 +378,14 @@ AASTOperator * expr::mod(std::vector<AASTNode *> & params) {
             throw invalid_call("mod", "Error: can't call mod on non-numerical types. ");
         }
         
-        if (param->type() == "num") {
+        if (isFloatingType(param->type())) {
             op = "fmod";
         }
         
     }
     
-    return new AASTOperator(op, "num", params);
+    /* Only fmod() returns a floating point number */
+    return new AASTOperator(op, op == "fmod" ? "num" : arithmeticType(params), params);
     
 }
 
@@ -152,9 +439,76 @@ AASTOperator * expr::binaryOperator(std::vector<AASTNode *> & params, const std:
         node = dereferencePtr(node);
     }
     
+    for (AASTNode * node : params) {
+        if (isVectorType(node->type())) {
+            return vectorOperator(params, op);
+        }
+    }
+    
     const std::string oper = binary_operators_map.at(op);
     
-    return new AASTOperator(binary_operators_map.at(op), params[0]->type(), params);
+    /* Logical operators result in an int */
+    if (op == "and" or op == "or") {
+        return new AASTOperator(oper, "int", params);
+    }
+    
+    return new AASTOperator(oper, arithmeticType(params), params);
+    
+}
+
+AASTOperator * expr::vectorOperator(std::vector<AASTNode *> & params, const std::string & op) {
+    
+    std::string type;
+    
+    for (AASTNode * node : params) {
+        
+        if (not isVectorType(node->type())) {
+            continue;
+        }
+        
+        if (type != "" and type != node->type()) {
+            throw type_mismatch("Error: Operands of (" + op + ") are vectors of different types: " +
+                                type + ", " + node->type());
+        }
+        
+        type = node->type();
+        
+    }
+    
+    const std::string element = vectorElementType(type);
+    
+    if (op == "and" or op == "or") {
+        throw invalid_call(op, "Error: Logical operators can't be applied to vectors. ");
+    }
+    
+    if ((op == "bit_and" or op == "bit_or" or op == "xor" or op == "lshift" or op == "rshift") and
+        isFloatingType(element)) {
+        throw invalid_call(op, "Error: Bitwise operators can't be applied to floating point vectors. ");
+    }
+    
+    /* C has no element-wise fmod() */
+    if (op == "mod" and isFloatingType(element)) {
+        throw invalid_call(op, "Error: mod can't be applied to floating point vectors. ");
+    }
+    
+    /* Scalars are broadcast to all lanes, C only allows it if the conversion doesn't truncate */
+    for (AASTNode *& node : params) {
+        
+        if (isVectorType(node->type())) {
+            continue;
+        }
+        
+        if (not isNumericalType(node->type())) {
+            throw type_mismatch("Error: Can't apply (" + op + ") to a vector and a value of type " + node->type());
+        }
+        
+        if (node->type() != element) {
+            node = new AASTCast(node, element);
+        }
+        
+    }
+    
+    return new AASTOperator(binary_operators_map.at(op), type, params);
     
 }
 
@@ -230,7 +584,7 @@ AASTOperator * expr::unaryOperator(AASTNode * param, const std::string & op) {
     
     std::string type;
     
-    if (op == "compl" and param->type() == "num") {
+    if (op == "compl" and isFloatingType(param->type())) {
         invalid_parameter("Invalid parameter in call (compl " + param->value() +
                           "): Operator compl doesn't accept parameters of type num");
     }
@@ -25,7 +25,9 @@
 namespace expr {
     
     /* An array of primitive Kobeři-C types */
-    const std::array<std::string, 6> native_types  = { "int", "uint", "num", "char", "uchar", "void" };
+    const std::array<std::string, 28> native_types  = { "int", "uint", "num", "char", "uchar", "void",
+        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64",
+        "f32x4", "f32x8", "f64x2", "f64x4", "i32x4", "i32x8", "i64x2", "i64x4", "u32x4", "u32x8", "i16x8", "u8x16" };
     
     /* An array of operators which take no parameters */
     const std::array<std::string, 3> parameterless_operators = { "return", "break", "continue" };
@@ -57,7 +59,7 @@ namespace expr {
         "const", "static", "double", "float", "register", "restrict", "signed",
         "volatile", "var",
         /* Constructs */
-        "if", "else", "elif", "while", "dowhile", "for", "do", "switch", "case", "default"
+        "if", "else", "elif", "while", "dowhile", "for", "pfor", "reduction", "do", "switch", "case", "default"
         /* Operators */
         "return", "break", "continue", "size_of", "sizeof", "inc", "dec", "equals",
         "not_eq", "and", "or", "not", "compl", "set", "lshift", "rshift", "xor", "bit_or",
@@ -65,11 +67,56 @@ namespace expr {
         /* Other */
         "typedef", "struct", "extern", "inline", "union",
         /* Kobeři-C keywords */
-        "_c", "new", "delete"
+        "_c", "new", "delete", "array", "at", "soa",
+        "vec_load", "vec_store", "vec_splat", "vec_shuffle", "vec_reduce_add", "vec_reduce_min", "vec_reduce_max",
+        "likely", "unlikely", "prefetch", "popcount", "clz", "ctz", "bswap", "assume_aligned",
+        "spawn", "sync", "coroutine", "await", "yield",
+        "atomic", "thread_local", "atomic_load", "atomic_store", "exchange", "fetch_add", "fetch_sub", "fetch_and", "fetch_or",
+        "fetch_xor", "cas", "cas_weak"
     };
     
+    /* Builtins which load, store, broadcast, permute and reduce SIMD vectors */
+    const std::array<std::string, 7> vector_builtins = { "vec_load", "vec_store", "vec_splat", "vec_shuffle",
+        "vec_reduce_add", "vec_reduce_min", "vec_reduce_max" };
+    
+    /* Builtins which give hints to the C compiler and manipulate bits, lowered to GCC/Clang builtins */
+    const std::array<std::string, 8> hint_builtins = { "likely", "unlikely", "prefetch", "popcount", "clz", "ctz",
+        "bswap", "assume_aligned" };
+    
+    /* Operations on atomic variables, lowered to C11 <stdatomic.h>, eg. (fetch_add counter 1 relaxed) */
+    const std::array<std::string, 10> atomic_builtins = { "atomic_load", "atomic_store", "exchange", "fetch_add",
+        "fetch_sub", "fetch_and", "fetch_or", "fetch_xor", "cas", "cas_weak" };
+    
+    /* Memory orders, which can be passed to atomic operations, seq_cst is used by default */
+    const std::array<std::string, 5> memory_orders = { "relaxed", "acquire", "release", "acq_rel", "seq_cst" };
+    
+    /* Type qualifiers, which can precede types of variables and parameters, eg. (const num* a) */
+    const std::array<std::string, 4> qualifiers = { "const", "restrict", "atomic", "thread_local" };
+    
+    /* Keyword options, which can be used in class definitions, eg. (class Particle () :pool ...) */
+    const std::array<std::string, 3> class_options = { "pool", "reorder", "align" };
+    
+    /* Keyword options, which can be used in function definitions, eg. (int add (int a int b) :export ...) */
+    /* Async functions are coroutines, calling them creates a coroutine, eg. (int fetch (int id) :async ...) */
+    const std::array<std::string, 2> function_options = { "export", "async" };
+    
+    /* Keyword options, which can be used in array declarations, eg. (array int values n :heap) */
+    const std::array<std::string, 1> array_options = { "heap" };
+    
+    /* Keyword options, which can be used in declarations of global variables and attributes, eg. (int hits :align 64) */
+    const std::array<std::string, 1> variable_options = { "align" };
+    
+    /* Keyword options, which can be used in loops, eg. (while :unroll 4 :ivdep cond ...) */
+    const std::array<std::string, 3> loop_options = { "unroll", "vectorize", "ivdep" };
+    
+    /* Options followed by a non-negative integer value, eg. :unroll 4, other options take no value */
+    const std::array<std::string, 2> valued_options = { "unroll", "align" };
+    
     /* Kobeři-C control flow constructs */
-    const std::array<std::string, 5> constructs = { "if", "elif", "else", "while", "dowhile" };
+    const std::array<std::string, 7> constructs = { "if", "elif", "else", "while", "dowhile", "for", "pfor" };
+    
+    /* Operators, which can be used in reduction clauses of parallel loops, eg. (pfor (i 0 n) (reduction + sum) ...) */
+    const std::array<std::string, 4> reduction_operators = { "+", "*", "min", "max" };
     
     /* Map which holds Kobeři-C unary operators and their respective operators in C */
     const std::unordered_map<std::string /* Kobeři-C operator */, std::string /* C operator */ > unary_operators_map = {
@@ -94,12 +141,25 @@ namespace expr {
         
     };
     
+    /* C operators which modify their operands or leave the current expression */
+    const std::array<std::string, 16> side_effect_operators = { "=", "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=",
+        "<<=", ">>=", "++", "--", "new", "delete", "return" };
+    
     /* Array of numerical types, which can easily be casted from one to another */
-    const std::array<std::string, 5> numerical_types = { "char", "uchar", "int", "uint", "num" };
+    const std::array<std::string, 15> numerical_types = { "char", "uchar", "int", "uint", "num",
+        "i8", "i16", "i32", "i64", "u8", "u16", "u32", "u64", "f32", "f64" };
+    
+    /* Numerical types printed as signed/unsigned integers and floating point types */
+    const std::array<std::string, 5> signed_types = { "int", "i8", "i16", "i32", "i64" };
+    const std::array<std::string, 5> unsigned_types = { "uint", "u8", "u16", "u32", "u64" };
+    const std::array<std::string, 3> floating_types = { "num", "f32", "f64" };
     
     /* Checks if parameter is a control flow construct */
     bool isConstruct(const std::string & construct);
     
+    /* Checks if parameter is an operator, which can be used in a reduction clause */
+    bool isReductionOperator(const std::string & op);
+    
     /* Checks if parameter is a Kobeři-C operator */
     bool isOperator(const std::string & op);
     
@@ -112,13 +172,78 @@ namespace expr {
     
     /* Checks if type is a numerical type */
     bool isNumericalType(const std::string & type);
+    bool isSignedType(const std::string & type);
+    bool isUnsignedType(const std::string & type);
+    bool isFloatingType(const std::string & type);
+    
+    /* Checks if type is a SIMD vector type, returns element type and number of lanes of a vector type */
+    bool isVectorType(const std::string & type);
+    std::string vectorElementType(const std::string & type);
+    int vectorLanes(const std::string & type);
+    bool isVectorBuiltin(const std::string & name);
+    bool isHintBuiltin(const std::string & name);
+    bool isAtomicBuiltin(const std::string & name);
+    bool isMemoryOrder(const std::string & order);
+    
+    /* Returns type of the result of an arithmetic operation                                  */
+    /* Floating point operands take precedence, wider floating types first, integer operands  */
+    /* are converted to the widest integer type, unsigned if the widest types differ in sign */
+    std::string arithmeticType(const std::vector<AASTNode *> & params);
+    /* Returns number of bits of an integer type, int and uint are 64 bits wide */
+    int integerWidth(const std::string & type);
+    /* Checks if integer type is unsigned, including uchar */
+    bool isUnsigned(const std::string & type);
+    
+    /* Checks if evaluating an expression may have side effects, calls are always assumed to have them */
+    bool hasSideEffects(AASTNode * node);
+    
+    /* Checks if parameter is a type qualifier */
+    bool isQualifier(const std::string & qualifier);
+    
+    /* Checks if parameter is a valid class/function/array option */
+    bool isClassOption(const std::string & option);
+    bool isFunctionOption(const std::string & option);
+    bool isArrayOption(const std::string & option);
+    bool isVariableOption(const std::string & option);
+    bool isLoopOption(const std::string & option);
+    bool isValuedOption(const std::string & option);
     
     /* Sets verbose mode to true/false */
     void setVerbose(bool value);
     bool isVerbose();
     
+    /* Allocates objects of all classes from per-class pools, not just classes marked with :pool */
+    void setPoolAllocation(bool value);
+    bool isPoolAllocation();
+    
+    /* Makes generated programs print pool allocator statistics at exit */
+    void setPoolStats(bool value);
+    bool isPoolStats();
+    
+    /* Reorders attributes of all classes, not just classes marked with :reorder */
+    void setReorderAttributes(bool value);
+    bool isReorderAttributes();
+    
+    /* Prints size, padding and cache line footprint of classes during compilation */
+    void setLayoutReport(bool value);
+    bool isLayoutReport();
+    
+    /* Makes generated programs count calls and cycles spent in functions and print them at exit */
+    void setInstrument(bool value);
+    bool isInstrument();
+    
+    /* Profile of an instrumented run used to mark hot and cold functions and biased branches */
+    void setProfileUse(const std::string & filename);
+    const std::string & getProfileUse();
+    
+    /* Directory with the standard library, imports not found relative to the working directory are looked up there */
+    void setStdLibPath(const std::string & path);
+    const std::string & getStdLibPath();
+    
     /* Analyzes binary operators */
     AASTOperator * binaryOperator(std::vector<AASTNode *> & params, const std::string & op);
+    /* Analyzes element-wise arithmetic on vectors, scalar operands are converted to the element type */
+    AASTOperator * vectorOperator(std::vector<AASTNode *> & params, const std::string & op);
     /* Analyzes mod operator */
     AASTOperator * mod(std::vector<AASTNode *> & params);
     /* Analyzes comparisons */
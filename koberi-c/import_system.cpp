@@ -7,6 +7,7 @@
 //
 
 #include "import_system.hpp"
+#include "expressions.hpp"
 #include <iostream>
 
 void trimFront(std::string & orig) {
@@ -223,8 +224,11 @@ void ImportSystem::parseImports(const std::string & filename) {
     
     /* Import files and data types */
     for (auto & i : imports) {
-        if (not isImported(i)) {
-            parseImports(i);
+        
+        const std::string path = resolveImport(i);
+        
+        if (not isImported(path)) {
+            parseImports(path);
         }
     }
     
@@ -239,6 +243,28 @@ void ImportSystem::parseImports(const std::string & filename) {
     }
 }
 
+std::string ImportSystem::resolveImport(const std::string & filename) {
+    
+    if (std::ifstream(filename + syntax::fileExtension)) {
+        return filename;
+    }
+    
+    const std::string & stdLibPath = expr::getStdLibPath();
+    
+    if (stdLibPath.size()) {
+        
+        const std::string path = stdLibPath + (stdLibPath.back() == '/' ? "" : "/") + filename;
+        
+        if (std::ifstream(path + syntax::fileExtension)) {
+            return path;
+        }
+        
+    }
+    
+    throw file_not_opened(filename + syntax::fileExtension);
+    
+}
+
 std::vector<std::string> ImportSystem::importTypes(const std::vector<std::string> & types) {
     
     std::vector<std::string> imports;
@@ -37,9 +37,8 @@ class ImportSystem {
     /* Checks if a Kobeři-C file has already been imported */
     bool isImported(const std::string & filename);
     
-    /* Imports C libraries or C data types unless they have already been imported */
+    /* Imports C data types unless they have already been imported */
     void importType(const std::string & type);
-    void importLib(const std::string & lib);
     
     /* Checks if vector includes value, if not, emplaces value into vector */
     /* Called from importType() and importLib()                            */
@@ -53,6 +52,10 @@ class ImportSystem {
     /* and returns them in a vector                                        */
     std::vector<std::string> importLibraries(const std::vector<std::string> & libs, bool isStdLib = false);
     
+    /* Returns path of an imported file without extension, files in the working directory take precedence */
+    /* over standard library modules, eg. #import "event_loop" finds event_loop.koberice in the std path */
+    std::string resolveImport(const std::string & filename);
+    
 public:
     
     void parseImports(const std::string & filename);
@@ -61,6 +64,10 @@ public:
     /* names of imported files are written without the extension           */
     void appendExtensions();
     
+    /* Imports C libraries unless they have already been imported                         */
+    /* Also used for libraries required by generated code, eg. <omp.h> for parallel loops */
+    void importLib(const std::string & lib);
+    
     const std::vector<std::string> & getImportedFiles();
     std::vector<std::string> & getExternTypes();
     std::vector<std::string> & getCLibs();
@@ -12,6 +12,7 @@
 KoberiC::KoberiC() : _tokenizer(_tokens),
                      _parser(_tokens, _ast),
                      _analyzer(_ast, _aast),
+                     _optimizer(_ast, _aast),
                      _translator(_ast, _aast) {
                          
     _tokens = {
@@ -33,6 +34,7 @@ void KoberiC::compile(const std::string & filename) {
     tokenize(filename);
     parse();
     analyze();
+    optimize();
     translate();
     
     std::cout << "Compilation successfully finished. " << std::endl;
@@ -74,6 +76,15 @@ void KoberiC::parse() {
     
     _parser.parse();
     
+    /* Parallel loops are translated to OpenMP pragmas */
+    if (_ast.usesOpenMP()) {
+        _importSystem.importLib("<omp.h>");
+    }
+    
+    if (_ast.usesAtomics()) {
+        _importSystem.importLib("<stdatomic.h>");
+    }
+    
     /* After the AST is created, there is no need to store the tokens any longer */
     /* Deleting tokens to save memory.                                           */
     _tokens = std::vector<token>();
@@ -88,6 +99,23 @@ void KoberiC::analyze() {
     
     _analyzer.analyze();
     
+    /* Spawned tasks are run by a scheduler built on top of pthreads */
+    if (_aast.spawnsTasks()) {
+        _importSystem.importLib("<pthread.h>");
+        _importSystem.importLib("<sched.h>");
+        _importSystem.importLib("<unistd.h>");
+    }
+    
+}
+
+void KoberiC::optimize() {
+    
+    if (expr::isVerbose()) {
+        std::cout << "\n" << "Optimizing..." << std::endl;
+    }
+    
+    _optimizer.optimize();
+    
 }
 
 void KoberiC::translate() {
@@ -21,6 +21,7 @@
 #include "traversable_ast.hpp"
 #include "analyzer.hpp"
 #include "analyzed_abstract_syntax_tree.hpp"
+#include "optimizer.hpp"
 #include "translator.hpp"
 #include "import_system.hpp"
 
@@ -40,6 +41,7 @@ class KoberiC {
     TraversableAbstractSyntaxTree _ast;
     AnalyzedAbstractSyntaxTree _aast;
     Analyzer _analyzer;
+    Optimizer _optimizer;
     Translator _translator;
     
     
@@ -53,6 +55,7 @@ class KoberiC {
     void tokenize(const std::string & filename);
     void parse();
     void analyze();
+    void optimize();
     void translate();
     
 public:
@@ -8,6 +8,8 @@
 
 #include "koberi-c.hpp"
 
+#include <cstdlib>
+
 #ifdef DEBUG_COMPILE_TEST
 static const std::string TEST = "test.koberice";
 #endif
@@ -31,10 +33,43 @@ int main(int argc, const char * argv[]) {
     
     std::string & file = args[0];
     
-    for (auto & a : args) {
+    const std::string profileUse = "--profile-use=";
+    const std::string stdPath = "--std-path=";
+    
+    /* Standard library is looked up in KOBERIC_STD_PATH unless --std-path is used */
+    if (const char * path = std::getenv("KOBERIC_STD_PATH")) {
+        expr::setStdLibPath(path);
+    }
+    
+    /* First argument is the compiled file, options follow */
+    for (size_t i = 1; i < args.size(); ++i) {
+        
+        const std::string & a = args[i];
+        
         if (a == "-v") {
             expr::setVerbose(true);
         }
+        else if (a == "--pool") {
+            expr::setPoolAllocation(true);
+        }
+        else if (a == "--pool-stats") {
+            expr::setPoolStats(true);
+        }
+        else if (a == "--reorder") {
+            expr::setReorderAttributes(true);
+        }
+        else if (a == "--layout-report") {
+            expr::setLayoutReport(true);
+        }
+        else if (a == "--instrument") {
+            expr::setInstrument(true);
+        }
+        else if (a.compare(0, profileUse.size(), profileUse) == 0 and a.size() > profileUse.size()) {
+            expr::setProfileUse(a.substr(profileUse.size()));
+        }
+        else if (a.compare(0, stdPath.size(), stdPath) == 0 and a.size() > stdPath.size()) {
+            expr::setStdLibPath(a.substr(stdPath.size()));
+        }
         else {
             std::cout << "Unknown parameter: " << a << std::endl;
             return -1;
@@ -69,3 +69,79 @@ std::string NameMangler::vtableName(const std::string & className) {
     
 }
 
+std::string NameMangler::poolName(const std::string & className) {
+    
+    const std::string pool = className + "_pl__" + "pool";
+    return pool;
+    
+}
+
+std::string NameMangler::poolAllocatorName(const std::string & className) {
+    
+    const std::string allocator = className + "_pl__" + "new";
+    return allocator;
+    
+}
+
+std::string NameMangler::poolDeallocatorName(const std::string & className) {
+    
+    const std::string deallocator = className + "_pl__" + "delete";
+    return deallocator;
+    
+}
+
+std::string NameMangler::copyFunctionName(const std::string & className) {
+    
+    const std::string copy = className + "_cp__" + "copy";
+    return copy;
+    
+}
+
+std::string NameMangler::taskName(const std::string & functionName) {
+    
+    const std::string task = functionName + "_tk__" + "task";
+    return task;
+    
+}
+
+std::string NameMangler::taskRunName(const std::string & functionName) {
+    
+    const std::string run = functionName + "_tk__" + "run";
+    return run;
+    
+}
+
+std::string NameMangler::taskSpawnName(const std::string & functionName) {
+    
+    const std::string spawn = functionName + "_tk__" + "spawn";
+    return spawn;
+    
+}
+
+std::string NameMangler::coroutineFrameName(const std::string & functionName) {
+    
+    const std::string frame = functionName + "_co__" + "frame";
+    return frame;
+    
+}
+
+std::string NameMangler::coroutineResumeName(const std::string & functionName) {
+    
+    const std::string resume = functionName + "_co__" + "resume";
+    return resume;
+    
+}
+
+std::string NameMangler::suspendLabel(size_t index) {
+    
+    const std::string label = "_co__" + std::to_string(index);
+    return label;
+    
+}
+
+std::string NameMangler::arrayLengthName(const std::string & arrayName) {
+    
+    const std::string length = arrayName + "__" + "length";
+    return length;
+    
+}
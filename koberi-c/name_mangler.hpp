@@ -38,6 +38,29 @@ public:
     /* Generates vtable name for class passed as parameter */
     static std::string vtableName(const std::string & className);
     
+    /* Generate names of the object pool of a class and functions which allocate and release its objects */
+    static std::string poolName(const std::string & className);
+    static std::string poolAllocatorName(const std::string & className);
+    static std::string poolDeallocatorName(const std::string & className);
+    
+    /* Generates name of the function which copies objects of a class */
+    static std::string copyFunctionName(const std::string & className);
+    
+    /* Generate names of the argument struct of a spawned function, the function which runs it as a task */
+    /* and the function which spawns it                                                                   */
+    static std::string taskName(const std::string & functionName);
+    static std::string taskRunName(const std::string & functionName);
+    static std::string taskSpawnName(const std::string & functionName);
+    
+    /* Generate names of the frame struct of an async function and the function which resumes it */
+    static std::string coroutineFrameName(const std::string & functionName);
+    static std::string coroutineResumeName(const std::string & functionName);
+    /* Generates name of the label, where a coroutine continues after it's index-th suspension point */
+    static std::string suspendLabel(size_t index);
+    
+    /* Generates name of the variable which holds the length of a heap array */
+    static std::string arrayLengthName(const std::string & arrayName);
+    
 };
 
 
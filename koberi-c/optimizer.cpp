@@ -0,0 +1,876 @@
+//
+//  optimizer.cpp
+//  koberi-c
+//
+
+#include "optimizer.hpp"
+
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+
+double constant::asNumber() const {
+    return isInteger ? (double)integer : number;
+}
+
+bool constant::isTrue() const {
+    return isInteger ? integer != 0 : number != 0;
+}
+
+Optimizer::Optimizer(TraversableAbstractSyntaxTree & ast, AnalyzedAbstractSyntaxTree & aast) : _ast(ast), _aast(aast) {
+    
+}
+
+void Optimizer::optimize() {
+    
+    for (AASTFunction * function : _aast.getFunctions()) {
+        optimizeScope(function->getBody());
+    }
+    
+    /* Folding removes dead branches first, so calls inside them don't keep functions alive */
+    removeUnreachable();
+    markInlineFunctions();
+    
+}
+
+void Optimizer::markInlineFunctions() {
+    
+    std::unordered_set<std::string> functions;
+    
+    for (AASTFunction * function : _aast.getFunctions()) {
+        functions.emplace(function->getName());
+    }
+    
+    for (AASTFunction * function : _aast.getFunctions()) {
+        
+        /* Inline functions with external linkage need an external definition in C */
+        if (function->isExported()) {
+            continue;
+        }
+        
+        bool leaf = true;
+        int functionCost = cost(function->getBody(), functions, leaf);
+        
+        function->setInline(leaf and functionCost <= inlineCostLimit);
+        
+    }
+    
+}
+
+int Optimizer::cost(AASTNode * node, const std::unordered_set<std::string> & functions, bool & leaf) {
+    
+    if (node == nullptr) {
+        return 0;
+    }
+    
+    int total = 1;
+    
+    switch (node->nodeType()) {
+        
+        case AASTNodeType::Scope:
+            for (AASTNode * child : ((AASTScope *)node)->getBody()) {
+                total += cost(child, functions, leaf);
+            }
+            break;
+        
+        case AASTNodeType::Construct: {
+            AASTConstruct * construct = (AASTConstruct *)node;
+            total += cost(construct->getCondition(), functions, leaf);
+            total += cost(construct->getBody(), functions, leaf);
+            break;
+        }
+        
+        case AASTNodeType::Funcall: {
+            
+            AASTFuncall * funcall = (AASTFuncall *)node;
+            const std::string & name = funcall->getName();
+            
+            /* Virtual methods are called through a function pointer expression */
+            bool isIdentifier = std::all_of(name.begin(), name.end(), [](char c) {
+                return syntax::isValidIdChar(c) or syntax::isNum(c);
+            });
+            
+            if (functions.count(name) or not isIdentifier) {
+                leaf = false;
+            }
+            
+            for (AASTNode * param : funcall->getParameters()) {
+                total += cost(param, functions, leaf);
+            }
+            break;
+        }
+        
+        case AASTNodeType::Operator:
+            for (AASTNode * param : ((AASTOperator *)node)->getParameters()) {
+                total += cost(param, functions, leaf);
+            }
+            break;
+        
+        case AASTNodeType::Declaration:
+            total += cost(((AASTDeclaration *)node)->getValue(), functions, leaf);
+            break;
+        
+        case AASTNodeType::Cast:
+            total += cost(((AASTCast *)node)->getValue(), functions, leaf);
+            break;
+        
+        default:
+            break;
+        
+    }
+    
+    return total;
+    
+}
+
+std::vector<std::string> Optimizer::identifiers(const std::string & code) {
+    
+    std::vector<std::string> ids;
+    
+    for (size_t i = 0; i < code.size(); ) {
+        
+        if (not syntax::isValidIdChar(code[i])) {
+            
+            /* Skip numbers, so suffixes aren't read as identifiers, eg. 10ll */
+            if (syntax::isNum(code[i])) {
+                while (i < code.size() and (syntax::isNum(code[i]) or syntax::isValidIdChar(code[i]))) {
+                    ++i;
+                }
+            } else {
+                ++i;
+            }
+            
+            continue;
+        }
+        
+        size_t begin = i;
+        
+        while (i < code.size() and (syntax::isValidIdChar(code[i]) or syntax::isNum(code[i]))) {
+            ++i;
+        }
+        
+        ids.emplace_back(code.substr(begin, i - begin));
+        
+    }
+    
+    return ids;
+    
+}
+
+void Optimizer::removeUnreachable() {
+    
+    /* Symbols are functions, vtables and classes, each symbol references other symbols */
+    /* References are found in the C code the symbol translates to                      */
+    std::unordered_map<std::string, std::vector<std::string>> references;
+    
+    for (AASTFunction * function : _aast.getFunctions()) {
+        references[function->getName()] = identifiers(function->value());
+    }
+    
+    for (AASTClass * cls : _aast.getClasses()) {
+        
+        const std::string & name = cls->type();
+        
+        references[name] = identifiers(cls->value());
+        references[NameMangler::vtableName(name)] = identifiers(cls->vtable());
+        
+        /* Functions generated by translator */
+        std::vector<std::string> & copy = references[NameMangler::copyFunctionName(name)];
+        std::vector<std::string> & allocator = references[NameMangler::poolAllocatorName(name)];
+        
+        copy.emplace_back(name);
+        allocator.emplace_back(name);
+        allocator.emplace_back(NameMangler::vtableName(name));
+        
+        for (const parameter & att : _ast.getClass(name).attributes) {
+            
+            if (not syntax::isPointerType(att.type) and _ast.isClass(att.type)) {
+                
+                std::string vtInitializer = NameMangler::mangleName(syntax::vtableInit, std::vector<std::string>());
+                
+                copy.emplace_back(NameMangler::copyFunctionName(att.type));
+                allocator.emplace_back(NameMangler::premangleMethodName(vtInitializer, att.type));
+            }
+            
+        }
+        
+        references[NameMangler::poolDeallocatorName(name)].emplace_back(name);
+        references[name + syntax::soaSuffix].emplace_back(name);
+        
+    }
+    
+    /* Spawned functions are called by their task, which is created by the spawn function */
+    for (const spawned_function & spawned : _aast.getSpawnedFunctions()) {
+        references[NameMangler::taskSpawnName(spawned.name)].emplace_back(spawned.name);
+    }
+    
+    std::unordered_set<std::string> reachable;
+    std::vector<std::string> stack = {
+        NameMangler::mangleName("main", std::vector<parameter>()),
+        NameMangler::mangleName("_globalVarInit", std::vector<parameter>())
+    };
+    
+    /* Exported functions may be called from other translation units */
+    for (AASTFunction * function : _aast.getFunctions()) {
+        if (function->isExported()) {
+            stack.emplace_back(function->getName());
+        }
+    }
+    
+    for (AASTDeclaration * declaration : _aast.getDeclarations()) {
+        for (const std::string & id : identifiers(declaration->value())) {
+            stack.emplace_back(id);
+        }
+    }
+    
+    while (not stack.empty()) {
+        
+        std::string symbol = stack.back();
+        stack.pop_back();
+        
+        if (reachable.count(symbol) or not references.count(symbol)) {
+            continue;
+        }
+        
+        reachable.emplace(symbol);
+        
+        for (const std::string & id : references.at(symbol)) {
+            if (not reachable.count(id)) {
+                stack.emplace_back(id);
+            }
+        }
+        
+    }
+    
+    /* Copy the vectors, because removing nodes modifies them */
+    const std::vector<AASTFunction *> functions = _aast.getFunctions();
+    const std::vector<AASTClass *> classes = _aast.getClasses();
+    
+    for (AASTFunction * function : functions) {
+        if (not reachable.count(function->getName())) {
+            _aast.removeFunction(function);
+        }
+    }
+    
+    for (AASTClass * cls : classes) {
+        
+        if (not reachable.count(cls->type())) {
+            _aast.removeClass(cls);
+            continue;
+        }
+        
+        cls->setInstantiated(reachable.count(NameMangler::vtableName(cls->type())));
+        
+    }
+    
+}
+
+bool Optimizer::getConstant(const AASTNode * node, constant & value) {
+    
+    if (node->nodeType() != AASTNodeType::Value) {
+        return false;
+    }
+    
+    const std::string & type = node->type();
+    
+    if (type != "int" and type != "num") {
+        return false;
+    }
+    
+    std::string literal = node->value();
+    
+    /* Negative constants are parenthesized */
+    if (literal.size() > 2 and literal.front() == '(' and literal.back() == ')') {
+        literal = literal.substr(1, literal.size() - 2);
+    }
+    
+    if (literal.empty() or not (syntax::isNum(literal.front()) or literal.front() == '-')) {
+        return false;
+    }
+    
+    const char * begin = literal.c_str();
+    char * end = nullptr;
+    errno = 0;
+    
+    if (type == "int") {
+        
+        value.isInteger = true;
+        value.integer = std::strtoll(begin, &end, 10);
+        
+        return errno == 0 and std::string(end) == "ll";
+        
+    }
+    
+    value.isInteger = false;
+    value.number = std::strtod(begin, &end);
+    
+    return errno == 0 and *end == '\0';
+    
+}
+
+AASTValue * Optimizer::createConstant(const constant & value, const std::string & type) {
+    
+    std::stringstream stream;
+    
+    if (value.isInteger) {
+        
+        stream << value.integer << "ll";
+        
+    } else {
+        
+        stream.precision(17);
+        stream << value.number;
+        
+        /* Make sure the literal is a floating point literal */
+        if (stream.str().find_first_of(".e") == std::string::npos) {
+            stream << ".0";
+        }
+        
+    }
+    
+    std::string literal = stream.str();
+    
+    if (literal.front() == '-') {
+        literal = "(" + literal + ")";
+    }
+    
+    return new AASTValue(literal, type);
+    
+}
+
+void Optimizer::deleteOperator(AASTOperator * op, const std::vector<AASTNode *> & extracted) {
+    
+    for (AASTNode *& param : op->getParameters()) {
+        for (AASTNode * node : extracted) {
+            if (param == node) {
+                param = nullptr;
+            }
+        }
+    }
+    
+    delete op;
+    
+}
+
+void Optimizer::deleteConstruct(AASTConstruct * construct) {
+    
+    delete construct->getBody();
+    delete construct;
+    
+}
+
+AASTNode * Optimizer::fold(AASTNode * node) {
+    
+    if (node == nullptr) {
+        return node;
+    }
+    
+    switch (node->nodeType()) {
+        
+        case AASTNodeType::Operator:
+            return foldOperator((AASTOperator *)node);
+        
+        case AASTNodeType::Cast:
+            return foldCast((AASTCast *)node);
+        
+        case AASTNodeType::Funcall:
+            for (AASTNode *& param : ((AASTFuncall *)node)->getParameters()) {
+                param = fold(param);
+            }
+            return node;
+        
+        case AASTNodeType::Declaration: {
+            AASTNode *& value = ((AASTDeclaration *)node)->getValue();
+            value = fold(value);
+            return node;
+        }
+        
+        case AASTNodeType::Construct: {
+            AASTConstruct * construct = (AASTConstruct *)node;
+            construct->getCondition() = fold(construct->getCondition());
+            construct->getIncrement() = fold(construct->getIncrement());
+            for (AASTDeclaration * initializer : construct->getInitializers()) {
+                fold(initializer);
+            }
+            optimizeScope(construct->getBody());
+            return node;
+        }
+        
+        case AASTNodeType::Scope:
+            optimizeScope((AASTScope *)node);
+            return node;
+        
+        default:
+            return node;
+        
+    }
+    
+}
+
+AASTNode * Optimizer::foldOperator(AASTOperator * op) {
+    
+    const std::string & oper = op->getOperator();
+    std::vector<AASTNode *> & params = op->getParameters();
+    
+    /* Lvalues and types mustn't be replaced by values */
+    if (oper == "&" or oper == "sizeof" or oper == "++" or oper == "--" or oper == "_c" or oper == "new") {
+        return op;
+    }
+    
+    for (size_t i = 0; i < params.size(); ++i) {
+        
+        /* Left side of an assignment stays untouched */
+        if (oper == "=" and i == 0) {
+            continue;
+        }
+        
+        params[i] = fold(params[i]);
+        
+    }
+    
+    /* Arithmetic negation of a negation */
+    if (oper == "-" and params.size() == 1 and params[0]->nodeType() == AASTNodeType::Operator) {
+        
+        AASTOperator * inner = (AASTOperator *)params[0];
+        
+        if (inner->getOperator() == "-" and inner->getParameters().size() == 1) {
+            
+            AASTNode * value = inner->getParameters()[0];
+            
+            deleteOperator(inner, { value });
+            params[0] = nullptr;
+            delete op;
+            
+            return value;
+            
+        }
+        
+    }
+    
+    std::vector<constant> values;
+    
+    for (AASTNode * param : params) {
+        
+        constant value;
+        
+        if (not getConstant(param, value)) {
+            break;
+        }
+        
+        values.emplace_back(value);
+        
+    }
+    
+    constant result;
+    
+    /* Short circuit evaluation skips the rest of the operands anyway */
+    if ((oper == "&&" or oper == "||") and not values.empty() and values.size() < params.size()) {
+        
+        for (const constant & value : values) {
+            
+            if (value.isTrue() == (oper == "||")) {
+                
+                result.integer = value.isTrue();
+                AASTValue * folded = createConstant(result, "int");
+                delete op;
+                
+                return folded;
+                
+            }
+            
+        }
+        
+    }
+    
+    if (values.size() != params.size() or values.empty()) {
+        return removeIdentities(op);
+    }
+    
+    bool evaluated = params.size() == 1 ? evaluateUnary(oper, values[0], result) : evaluate(oper, values, result);
+    
+    if (not evaluated) {
+        return op;
+    }
+    
+    /* Results of num expressions keep their type, even if the operator node has a different type */
+    const std::string type = result.isInteger ? "int" : "num";
+    
+    AASTValue * folded = createConstant(result, type);
+    delete op;
+    
+    return folded;
+    
+}
+
+bool Optimizer::evaluateUnary(const std::string & op, const constant & value, constant & result) {
+    
+    result = value;
+    
+    if (op == "-") {
+        
+        if (value.isInteger) {
+            result.integer = (long long)(0ull - (unsigned long long)value.integer);
+        } else {
+            result.number = -value.number;
+        }
+        
+        return true;
+        
+    }
+    
+    if (op == "!") {
+        
+        result = constant();
+        result.integer = not value.isTrue();
+        
+        return true;
+        
+    }
+    
+    if (op == "~" and value.isInteger) {
+        
+        result.integer = ~value.integer;
+        
+        return true;
+        
+    }
+    
+    return false;
+    
+}
+
+bool Optimizer::evaluate(const std::string & op, const std::vector<constant> & values, constant & result) {
+    
+    bool isInteger = true;
+    
+    for (const constant & value : values) {
+        isInteger = isInteger and value.isInteger;
+    }
+    
+    /* Chained comparisons are evaluated pairwise, (< a b c) -> a < b && b < c */
+    if (op == "<" or op == ">" or op == "<=" or op == ">=" or op == "==" or op == "!=") {
+        
+        result = constant();
+        result.integer = 1;
+        
+        for (size_t i = 1; i < values.size(); ++i) {
+            
+            const constant & a = values[i - 1];
+            const constant & b = values[i];
+            
+            bool holds;
+            
+            if (a.isInteger and b.isInteger) {
+                holds = op == "<"  ? a.integer <  b.integer :
+                        op == ">"  ? a.integer >  b.integer :
+                        op == "<=" ? a.integer <= b.integer :
+                        op == ">=" ? a.integer >= b.integer :
+                        op == "==" ? a.integer == b.integer :
+                                     a.integer != b.integer;
+            } else {
+                holds = op == "<"  ? a.asNumber() <  b.asNumber() :
+                        op == ">"  ? a.asNumber() >  b.asNumber() :
+                        op == "<=" ? a.asNumber() <= b.asNumber() :
+                        op == ">=" ? a.asNumber() >= b.asNumber() :
+                        op == "==" ? a.asNumber() == b.asNumber() :
+                                     a.asNumber() != b.asNumber();
+            }
+            
+            result.integer = result.integer and holds;
+            
+        }
+        
+        return true;
+        
+    }
+    
+    if (op == "&&" or op == "||") {
+        
+        result = constant();
+        result.integer = op == "&&";
+        
+        for (const constant & value : values) {
+            result.integer = op == "&&" ? result.integer and value.isTrue() : result.integer or value.isTrue();
+        }
+        
+        return true;
+        
+    }
+    
+    result = values[0];
+    
+    for (size_t i = 1; i < values.size(); ++i) {
+        
+        const constant & value = values[i];
+        
+        if (not isInteger) {
+            
+            double a = result.asNumber();
+            double b = value.asNumber();
+            
+            result.isInteger = false;
+            
+            if (op == "+") {
+                result.number = a + b;
+            } else if (op == "-") {
+                result.number = a - b;
+            } else if (op == "*") {
+                result.number = a * b;
+            } else if (op == "/" and b != 0) {
+                result.number = a / b;
+            } else if (op == "fmod" and b != 0) {
+                result.number = std::fmod(a, b);
+            } else {
+                return false;
+            }
+            
+            if (not std::isfinite(result.number)) {
+                return false;
+            }
+            
+            continue;
+            
+        }
+        
+        /* Unsigned arithmetic wraps around instead of overflowing */
+        unsigned long long a = (unsigned long long)result.integer;
+        unsigned long long b = (unsigned long long)value.integer;
+        
+        if (op == "+") {
+            result.integer = (long long)(a + b);
+        } else if (op == "-") {
+            result.integer = (long long)(a - b);
+        } else if (op == "*") {
+            result.integer = (long long)(a * b);
+        } else if ((op == "/" or op == "%") and value.integer != 0 and
+                   not (result.integer == LLONG_MIN and value.integer == -1)) {
+            result.integer = op == "/" ? result.integer / value.integer : result.integer % value.integer;
+        } else if (op == "&") {
+            result.integer = (long long)(a & b);
+        } else if (op == "|") {
+            result.integer = (long long)(a | b);
+        } else if (op == "^") {
+            result.integer = (long long)(a ^ b);
+        } else if ((op == "<<" or op == ">>") and value.integer >= 0 and value.integer < 64 and result.integer >= 0) {
+            result.integer = op == "<<" ? (long long)(a << b) : result.integer >> value.integer;
+        } else {
+            return false;
+        }
+        
+    }
+    
+    return true;
+    
+}
+
+AASTNode * Optimizer::removeIdentities(AASTOperator * op) {
+    
+    const std::string & oper = op->getOperator();
+    std::vector<AASTNode *> & params = op->getParameters();
+    
+    if (params.size() < 2) {
+        return op;
+    }
+    
+    long long identity;
+    size_t first;
+    
+    /* Zero can be removed from any position of a sum, but only from the right side of subtraction */
+    if (oper == "+" or oper == "-") {
+        identity = 0;
+        first = oper == "+" ? 0 : 1;
+    } else if (oper == "*" or oper == "/") {
+        identity = 1;
+        first = oper == "*" ? 0 : 1;
+    } else {
+        return op;
+    }
+    
+    std::vector<AASTNode *> remaining;
+    std::vector<AASTNode *> removed;
+    
+    for (size_t i = 0; i < params.size(); ++i) {
+        
+        constant value;
+        
+        /* Only integer literals are removed, removing floating point literals could change type of result */
+        if (i >= first and getConstant(params[i], value) and value.isInteger and value.integer == identity) {
+            removed.emplace_back(params[i]);
+        } else {
+            remaining.emplace_back(params[i]);
+        }
+        
+    }
+    
+    if (removed.empty() or remaining.empty()) {
+        return op;
+    }
+    
+    if (remaining.size() == 1) {
+        
+        AASTNode * value = remaining[0];
+        deleteOperator(op, remaining);
+        
+        return value;
+        
+    }
+    
+    params = remaining;
+    
+    for (AASTNode * node : removed) {
+        delete node;
+    }
+    
+    return op;
+    
+}
+
+AASTNode * Optimizer::foldCast(AASTCast * cast) {
+    
+    AASTNode *& value = cast->getValue();
+    value = fold(value);
+    
+    constant c;
+    
+    if (not getConstant(value, c)) {
+        return cast;
+    }
+    
+    const std::string & type = cast->type();
+    
+    /* Casts which don't change the kind of a literal are kept, the C type of literals */
+    /* isn't necessarily the same as the type they're cast to, eg. long long, intmax_t */
+    if ((type == "int") == c.isInteger) {
+        return cast;
+    }
+    
+    if (type == "int" and not c.isInteger) {
+        
+        /* Conversion of out of range values is undefined, leave it to the C compiler */
+        if (not (c.number > (double)LLONG_MIN and c.number < (double)LLONG_MAX)) {
+            return cast;
+        }
+        
+        c.isInteger = true;
+        c.integer = (long long)c.number;
+        
+    } else if (type == "num" and c.isInteger) {
+        
+        c.isInteger = false;
+        c.number = (double)c.integer;
+        
+    } else if (type != "int" and type != "num") {
+        return cast;
+    }
+    
+    AASTValue * folded = createConstant(c, type);
+    delete cast;
+    
+    return folded;
+    
+}
+
+void Optimizer::optimizeScope(AASTScope * scope) {
+    
+    std::vector<AASTNode *> & body = scope->getBody();
+    std::vector<AASTNode *> optimized;
+    
+    /* Whether a branch of current if/elif/else chain is known to be taken */
+    bool branchTaken = false;
+    /* Whether a branch of current chain has been emitted, if not, elif becomes if */
+    bool branchEmitted = false;
+    
+    for (AASTNode * node : body) {
+        
+        node = fold(node);
+        
+        if (node->nodeType() != AASTNodeType::Construct) {
+            optimized.emplace_back(node);
+            continue;
+        }
+        
+        AASTConstruct * construct = (AASTConstruct *)node;
+        const std::string kind = construct->getConstruct();
+        
+        if (kind == "if") {
+            branchTaken = false;
+            branchEmitted = false;
+        }
+        
+        if ((kind == "else if" or kind == "else") and branchTaken) {
+            deleteConstruct(construct);
+            continue;
+        }
+        
+        if (kind == "else") {
+            
+            /* All previous branches were removed, else becomes a plain scope */
+            if (not branchEmitted) {
+                optimized.emplace_back(construct->getBody());
+                construct->getBody() = nullptr;
+                deleteConstruct(construct);
+            } else {
+                optimized.emplace_back(construct);
+            }
+            
+            continue;
+            
+        }
+        
+        constant condition;
+        const bool isConstant = getConstant(construct->getCondition(), condition);
+        
+        if (kind == "while" and isConstant and not condition.isTrue()) {
+            deleteConstruct(construct);
+            continue;
+        }
+        
+        if (kind != "if" and kind != "else if") {
+            optimized.emplace_back(construct);
+            continue;
+        }
+        
+        if (isConstant and not condition.isTrue()) {
+            deleteConstruct(construct);
+            continue;
+        }
+        
+        if (isConstant) {
+            
+            branchTaken = true;
+            
+            /* Branch is always taken, the rest of the chain is dead */
+            if (not branchEmitted) {
+                optimized.emplace_back(construct->getBody());
+            } else {
+                optimized.emplace_back(new AASTConstruct("else", nullptr, construct->getBody()));
+            }
+            
+            construct->getBody() = nullptr;
+            deleteConstruct(construct);
+            
+            continue;
+            
+        }
+        
+        if (kind == "else if" and not branchEmitted) {
+            
+            optimized.emplace_back(new AASTConstruct("if", construct->getCondition(), construct->getBody()));
+            
+            construct->getCondition() = nullptr;
+            construct->getBody() = nullptr;
+            deleteConstruct(construct);
+            
+        } else {
+            optimized.emplace_back(construct);
+        }
+        
+        branchEmitted = true;
+        
+    }
+    
+    body = optimized;
+    
+}
@@ -0,0 +1,95 @@
+//
+//  optimizer.hpp
+//  koberi-c
+//
+
+#ifndef optimizer_hpp
+#define optimizer_hpp
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "analyzed_abstract_syntax_tree.hpp"
+#include "traversable_ast.hpp"
+#include "aast_node.hpp"
+#include "name_mangler.hpp"
+#include "syntax.hpp"
+
+/* Value of a numerical literal, used to evaluate expressions at compile time */
+
+struct constant {
+    
+    bool isInteger = true;
+    long long integer = 0;
+    double number = 0;
+    
+    double asNumber() const;
+    bool isTrue() const;
+    
+};
+
+/* Optimizer class, which transforms AnalyzedAST before translation                     */
+/* Folds constant expressions, simplifies identities (x + 0, x * 1, (- (- x))) and      */
+/* removes branches of if/elif/else chains and loops with constant-false conditions     */
+/* Removes functions, methods and classes which can't be reached from main              */
+/* Marks small leaf functions inline                                                    */
+
+class Optimizer {
+    
+    TraversableAbstractSyntaxTree & _ast;
+    AnalyzedAbstractSyntaxTree & _aast;
+    
+    /* Maximal cost of a function body, which is still marked inline */
+    static const int inlineCostLimit = 24;
+    
+    /* Marks non-exported leaf functions with cost under inlineCostLimit inline */
+    void markInlineFunctions();
+    
+    /* Estimates the size of generated code, each node costs at least one      */
+    /* Sets leaf to false if node calls a Kobeři-C function or a virtual method */
+    int cost(AASTNode * node, const std::unordered_set<std::string> & functions, bool & leaf);
+    
+    /* Finds all symbols reachable from main and _globalVarInit, removes unreachable     */
+    /* functions and classes and marks classes, which are never instantiated, as such   */
+    /* Methods are reachable through vtables of instantiated classes                    */
+    void removeUnreachable();
+    
+    /* Returns identifiers used in a piece of C code */
+    std::vector<std::string> identifiers(const std::string & code);
+    
+    /* Folds constants in node and it's child nodes, returns simplified node */
+    /* Returned node may be a new node, in which case the original node is deleted */
+    AASTNode * fold(AASTNode * node);
+    AASTNode * foldOperator(AASTOperator * op);
+    AASTNode * foldCast(AASTCast * cast);
+    
+    /* Evaluates operator with constant parameters, returns false if it can't be evaluated */
+    bool evaluate(const std::string & op, const std::vector<constant> & values, constant & result);
+    bool evaluateUnary(const std::string & op, const constant & value, constant & result);
+    
+    /* Removes operands which don't change the result, eg. zeros in addition */
+    AASTNode * removeIdentities(AASTOperator * op);
+    
+    /* Folds all nodes of a scope and removes dead branches of constructs */
+    void optimizeScope(AASTScope * scope);
+    
+    /* Checks if node is a numerical literal and parses it's value */
+    bool getConstant(const AASTNode * node, constant & value);
+    /* Creates a literal holding a constant */
+    AASTValue * createConstant(const constant & value, const std::string & type);
+    
+    /* Deletes a node, child nodes in extracted are detached first so they aren't deleted */
+    void deleteOperator(AASTOperator * op, const std::vector<AASTNode *> & extracted);
+    void deleteConstruct(AASTConstruct * construct);
+    
+public:
+    
+    Optimizer(TraversableAbstractSyntaxTree & ast, AnalyzedAbstractSyntaxTree & aast);
+    
+    void optimize();
+    
+};
+
+#endif /* optimizer_hpp */
@@ -0,0 +1,17 @@
+//
+//  options.hpp
+//  koberi-c
+//
+
+#ifndef options_hpp
+#define options_hpp
+
+#include <string>
+#include <unordered_map>
+
+/* Keyword options written after a class header, eg. (class Particle () :pool ...)  */
+/* Options without a value are stored with an empty string as their value           */
+
+typedef std::unordered_map<std::string /* option name without colon */, std::string /* value */> Options;
+
+#endif /* options_hpp */
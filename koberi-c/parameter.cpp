@@ -32,6 +32,7 @@ parameter::parameter(const parameter & param) : name(this->value) {
     
     value = param.value;
     type = param.type;
+    qualifiers = param.qualifiers;
     
 }
 
@@ -39,6 +40,7 @@ parameter & parameter::operator= (const parameter & param) {
     
     value = param.value;
     type = param.type;
+    qualifiers = param.qualifiers;
     
     return *this;
     
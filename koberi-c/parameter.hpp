@@ -17,9 +17,27 @@
 /* It got it's name because it was originally used to store function */
 /* parameters, though it's probably used in other situations, too    */
 
+/* Qualifiers of variables and parameters                                   */
+/* Const pointers point to constant values, the pointer itself can change */
+/* Restrict pointers don't alias any other pointer in the same scope      */
+/* Atomic variables are only accessed using atomic operations             */
+/* Thread local globals have a separate instance in each thread           */
+/* Alignment set by :align, 0 if variable is naturally aligned            */
+
+struct type_qualifiers {
+    
+    bool isConst = false;
+    bool isRestrict = false;
+    bool isAtomic = false;
+    bool isThreadLocal = false;
+    size_t alignment = 0;
+    
+};
+
 struct parameter {
     
     std::string type;
+    type_qualifiers qualifiers;
     
     /* Use value for literals, name for variable names */
     /* They both refer to the same object */
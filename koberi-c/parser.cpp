@@ -20,7 +20,9 @@ std::string Parser::getType(token & tok) {
     
     std::string type;
     
-    if (tok == tokType::intLit) {
+    if (literalSuffix(tok.value) != "") {
+        type = literalSuffix(tok.value);
+    } else if (tok == tokType::intLit) {
         type = "int";
     } else if (tok == tokType::numLit) {
         type = "num";
@@ -44,8 +46,53 @@ bool Parser::isLiteral(unsigned long long tokenIndex) {
     
 }
 
+std::string Parser::literalSuffix(const std::string & literal) {
+    
+    size_t suffixBeginning = 0;
+    
+    while (suffixBeginning < literal.size() and not syntax::isValidIdChar(literal[suffixBeginning])) {
+        ++suffixBeginning;
+    }
+    
+    const std::string suffix = literal.substr(suffixBeginning);
+    
+    return syntax::sizedTypes.count(suffix) ? suffix : "";
+    
+}
+
+std::string Parser::sizedLiteral(const std::string & literal, const std::string & type) {
+    
+    std::string value = literal.substr(0, literal.size() - type.size());
+    
+    if (expr::isFloatingType(type)) {
+        
+        if (value.find('.') == std::string::npos) {
+            value += ".0";
+        }
+        
+        return type == "f32" ? value + "f" : value;
+        
+    }
+    
+    /* Integer literals are cast, C has no suffixes for types narrower than int */
+    const std::string suffix = expr::isUnsignedType(type) ? "ull" : "ll";
+    
+    return "((" + syntax::sizedTypes.at(type) + ")" + value + suffix + ")";
+    
+}
+
 ASTLiteral Parser::createLiteral(unsigned long long literalIndex) {
     
+    const std::string & value = _tokens[literalIndex].value;
+    const std::string suffix = literalSuffix(value);
+    
+    /* Literals with a type suffix, eg. 5u8 or 2.5f32 */
+    if ((_tokens[literalIndex] == tokType::intLit or _tokens[literalIndex] == tokType::numLit) and suffix != "") {
+        
+        return ASTLiteral(suffix, sizedLiteral(value, suffix));
+        
+    }
+    
     if (_tokens[literalIndex] == tokType::strLit) {
         
         return ASTLiteral("char*", _tokens[literalIndex].value);
@@ -72,6 +119,9 @@ void Parser::parseParams(unsigned long long beginning, std::vector<parameter> &
     
     for (unsigned long long i = beginning + 1; _tokens[i] != tokType::closingPar and _tokens[i+1] != tokType::closingPar; i += 2) {
         
+        /* Parameters may be qualified, eg. (const num* restrict num* b) */
+        const type_qualifiers qualifiers = parseQualifiers(i);
+        
         if (_tokens[i] == tokType::closingPar or _tokens[i+1] == tokType::closingPar) { break; }
         params.emplace_back();
         
@@ -82,11 +132,35 @@ void Parser::parseParams(unsigned long long beginning, std::vector<parameter> &
         
         params.back().type = _tokens[i].value;
         params.back().name = _tokens[i+1].value;
+        params.back().qualifiers = qualifiers;
         
     }
     
 }
 
+type_qualifiers Parser::parseQualifiers(unsigned long long & iter) {
+    
+    type_qualifiers qualifiers;
+    
+    for (; _tokens[iter] == tokType::id and expr::isQualifier(_tokens[iter].value); ++iter) {
+        
+        const std::string & value = _tokens[iter].value;
+        bool & qualifier = value == "const" ? qualifiers.isConst :
+                           value == "restrict" ? qualifiers.isRestrict :
+                           value == "atomic" ? qualifiers.isAtomic : qualifiers.isThreadLocal;
+        
+        if (qualifier) {
+            throw invalid_syntax("Error: Duplicate qualifier " + _tokens[iter].value + ". ");
+        }
+        
+        qualifier = true;
+        
+    }
+    
+    return qualifiers;
+    
+}
+
 
 void Parser::parseSexp(unsigned long long sexpBeginning) {
     
@@ -96,10 +170,20 @@ void Parser::parseSexp(unsigned long long sexpBeginning) {
     
     /* If first token is data type, sexp is a variable declaration               */
     /* Functions can't be defined inside functions (unless you compile with GCC) */
-    if ( _ast.isDataType(_tokens[sexpBeginning + 1].value) ) {
+    if ( _ast.isDataType(_tokens[sexpBeginning + 1].value) or expr::isQualifier(_tokens[sexpBeginning + 1].value) ) {
         
         localVarDeclaration(sexpBeginning, sexpEnd);
     
+    }
+    else if (_tokens[sexpBeginning + 1].value == "array") {
+        
+        arrayDeclaration(sexpBeginning, sexpEnd);
+        
+    }
+    else if (_tokens[sexpBeginning + 1].value == "soa") {
+        
+        soaDeclaration(sexpBeginning, sexpEnd);
+        
     }
     else if (expr::isConstruct(_tokens[sexpBeginning + 1].value)) {
         
@@ -123,6 +207,11 @@ void Parser::parseSexp(unsigned long long sexpBeginning) {
 
 void Parser::localVarDeclaration(unsigned long long declBeginning, unsigned long long declEnd) {
     
+    /* Skip qualifiers, so the declaration can be parsed the same way as unqualified declarations */
+    unsigned long long typeIndex = declBeginning + 1;
+    const type_qualifiers qualifiers = parseQualifiers(typeIndex);
+    declBeginning = typeIndex - 1;
+    
     const std::string type = _tokens[declBeginning + 1].value;
     
     if ( not _ast.isDataType(type) ) {
@@ -158,7 +247,7 @@ void Parser::localVarDeclaration(unsigned long long declBeginning, unsigned long
         
     }
     
-    _ast.emplaceDeclaration(type, name, node);
+    _ast.emplaceDeclaration(type, name, node, qualifiers);
     
     /* Call vtable pointer initializer after declaring variable */
     
@@ -170,39 +259,155 @@ void Parser::localVarDeclaration(unsigned long long declBeginning, unsigned long
     
 }
 
+void Parser::soaDeclaration(unsigned long long declBeginning, unsigned long long declEnd) {
+    
+    /* (soa Class name length) */
+    const std::string className = _tokens[declBeginning + 2].value;
+    const std::string name = _tokens[declBeginning + 3].value;
+    
+    if (syntax::isPointerType(className) or not _ast.isClass(className)) {
+        throw invalid_declaration("Struct-of-arrays container " + name + " must contain a class, not " + className);
+    }
+    
+    const unsigned long long lengthBeginning = declBeginning + 4;
+    unsigned long long lengthEnd = lengthBeginning;
+    
+    ASTNode * length = nullptr;
+    
+    if (_tokens[lengthBeginning] == tokType::openingPar) {
+        
+        lengthEnd = findSexpEnd(lengthBeginning);
+        length = new ASTFunCall(parseFunCall(lengthBeginning, lengthEnd));
+        
+    } else if (_tokens[lengthBeginning] == tokType::id) {
+        
+        length = new ASTVariable(_tokens[lengthBeginning].value, _ast.getCurrentScopePtr());
+        
+    } else if (_tokens[lengthBeginning] == tokType::intLit) {
+        
+        length = new ASTLiteral(createLiteral(lengthBeginning));
+        
+    } else {
+        throw invalid_declaration("Struct-of-arrays container " + name + " must be declared with a length");
+    }
+    
+    if (lengthEnd + 1 != declEnd) {
+        throw invalid_declaration("Invalid declaration of struct-of-arrays container " + name);
+    }
+    
+    _ast.emplaceSoaDeclaration(className, name, length);
+    
+}
+
+void Parser::arrayDeclaration(unsigned long long declBeginning, unsigned long long declEnd) {
+    
+    /* (array type name length :options) */
+    const std::string type = _tokens[declBeginning + 2].value;
+    const std::string name = _tokens[declBeginning + 3].value;
+    
+    if ( not _ast.isDataType(type) or type == "void" or type == "var" ) {
+        throw invalid_declaration("Invalid type of array elements " + type);
+    }
+    
+    unsigned long long lengthBeginning = declBeginning + 4;
+    unsigned long long optionsBeginning = lengthBeginning + 1;
+    
+    ASTNode * length = nullptr;
+    
+    if (_tokens[lengthBeginning] == tokType::openingPar) {
+        
+        unsigned long long funcallEnd = findSexpEnd(lengthBeginning);
+        length = new ASTFunCall(parseFunCall(lengthBeginning, funcallEnd));
+        optionsBeginning = funcallEnd + 1;
+        
+    } else if (_tokens[lengthBeginning] == tokType::id) {
+        
+        length = new ASTVariable(_tokens[lengthBeginning].value, _ast.getCurrentScopePtr());
+        
+    } else if (_tokens[lengthBeginning] == tokType::intLit) {
+        
+        length = new ASTLiteral(createLiteral(lengthBeginning));
+        
+    } else {
+        throw invalid_declaration("Array " + name + " must be declared with a length");
+    }
+    
+    Options options = parseOptions(optionsBeginning);
+    
+    for (const auto & option : options) {
+        
+        if (not expr::isArrayOption(option.first)) {
+            throw invalid_syntax("Error: Unknown option :" + option.first + " in declaration of array " + name + ". ");
+        }
+        
+    }
+    
+    if (optionsBeginning != declEnd) {
+        throw invalid_declaration("Invalid declaration of array " + name);
+    }
+    
+    /* Stack arrays are plain C arrays, which need their length known at compile time */
+    const bool onHeap = options.count("heap");
+    
+    if (not onHeap and length->nodeType != NodeType::Literal) {
+        throw invalid_declaration("Length of array " + name + " must be an integer literal, use :heap for " +
+                                  "arrays with length known at runtime");
+    }
+    
+    _ast.emplaceArrayDeclaration(type, name, length, onHeap);
+    
+}
+
 void Parser::parseConstruct(unsigned long long constructBeginning, unsigned long long constructEnd) {
     
     std::string construct = _tokens[constructBeginning + 1].value;
     
-    unsigned long long condEnd = constructBeginning + 2;
+    /* Loops may be preceded by hints, eg. (while :unroll 4 :ivdep cond ...) */
+    unsigned long long condBeginning = constructBeginning + 2;
+    Options options = parseOptions(condBeginning);
+    
+    for (const auto & option : options) {
+        
+        if (not expr::isLoopOption(option.first) or not (construct == "while" or construct == "dowhile" or
+                                                         construct == "for")) {
+            throw invalid_syntax("Error: Unknown option :" + option.first + " in construct " + construct + ". ");
+        }
+        
+        /* Only :unroll takes a value, the unroll factor */
+        if ((option.first == "unroll") == (option.second == "")) {
+            throw invalid_syntax("Error: Invalid value of option :" + option.first + " in construct " + construct + ". ");
+        }
+        
+    }
+    
+    unsigned long long condEnd = condBeginning;
     
     
     ASTNode * condition;
     
     if (construct != "else") {
         
-        if (_tokens[constructBeginning + 2].type == tokType::intLit or
-            _tokens[constructBeginning + 2].type == tokType::numLit or
-            _tokens[constructBeginning + 2].type == tokType::charLit) {
+        if (_tokens[condBeginning].type == tokType::intLit or
+            _tokens[condBeginning].type == tokType::numLit or
+            _tokens[condBeginning].type == tokType::charLit) {
             
             std::string type;
             
-            if (_tokens[constructBeginning + 2].type == tokType::intLit) {
+            if (_tokens[condBeginning].type == tokType::intLit) {
                 type = "int";
-            } else if (_tokens[constructBeginning + 2].type == tokType::numLit) {
+            } else if (_tokens[condBeginning].type == tokType::numLit) {
                 type = "num";
-            } else if (_tokens[constructBeginning + 2].type == tokType::charLit) {
+            } else if (_tokens[condBeginning].type == tokType::charLit) {
                 type = "char";
             }
             
-            condition = new ASTLiteral(type, _tokens[constructBeginning + 2].value);
+            condition = new ASTLiteral(type, _tokens[condBeginning].value);
             
         }
-        else if (_tokens[constructBeginning + 2].type == tokType::openingBra) {
+        else if (_tokens[condBeginning].type == tokType::openingBra) {
             
-            constructBeginning += 2;
-            condition = new ASTMemberAccess(parseMemberAccess(constructBeginning));
-            condEnd = constructBeginning;
+            condition = new ASTMemberAccess(parseMemberAccess(condBeginning));
+            condEnd = condBeginning;
             while (_tokens[condEnd].type != tokType::closingBra) {
                 ++condEnd;
                 if (condEnd == _tokens.size()) {
@@ -211,12 +416,12 @@ void Parser::parseConstruct(unsigned long long constructBeginning, unsigned long
             }
             
         }
-        else if (_tokens[constructBeginning + 2].type == tokType::id){
-            condition = new ASTVariable(_tokens[constructBeginning + 2].value, _ast.getCurrentScopePtr());
+        else if (_tokens[condBeginning].type == tokType::id){
+            condition = new ASTVariable(_tokens[condBeginning].value, _ast.getCurrentScopePtr());
         }
         else {
-            condEnd = findSexpEnd(constructBeginning + 2);
-            condition = new ASTFunCall(parseFunCall(constructBeginning + 2, condEnd));
+            condEnd = findSexpEnd(condBeginning);
+            condition = new ASTFunCall(parseFunCall(condBeginning, condEnd));
         }
         
     }
@@ -226,7 +431,59 @@ void Parser::parseConstruct(unsigned long long constructBeginning, unsigned long
     }
     
     
-    _ast.emplaceConstruct(construct, condition);
+    /* Parallel loops may be followed by reduction clauses, eg. (pfor (i 0 n) (reduction + sum) ...) */
+    std::map<std::string, std::string> reductions;
+    
+    while (construct == "pfor" and condEnd + 2 < constructEnd and _tokens[condEnd + 1] == tokType::openingPar and
+           _tokens[condEnd + 2].value == "reduction") {
+        
+        const unsigned long long clauseEnd = findSexpEnd(condEnd + 1);
+        const std::string op = _tokens[condEnd + 3].value;
+        
+        if (not expr::isReductionOperator(op) or clauseEnd < condEnd + 5) {
+            throw invalid_syntax("Error: Invalid reduction, expected (reduction +|*|min|max variables...). ");
+        }
+        
+        for (unsigned long long var = condEnd + 4; var < clauseEnd; ++var) {
+            
+            if (_tokens[var] != tokType::id or reductions.count(_tokens[var].value)) {
+                throw invalid_syntax("Error: Invalid reduction variable " + _tokens[var].value + ". ");
+            }
+            
+            reductions[_tokens[var].value] = op;
+            
+        }
+        
+        condEnd = clauseEnd;
+        
+    }
+    
+    _ast.emplaceConstruct(construct, condition, options);
+    ((ASTConstruct *)_ast.getCurrentScopePtr())->reductions = reductions;
+    
+    /* Counted loops (for (i begin end step) ...) declare their induction variable in the loop scope */
+    if (construct == "for" or construct == "pfor") {
+        
+        if (condition->nodeType != NodeType::FunCall or ((ASTFunCall *)condition)->object != nullptr or
+            ((ASTFunCall *)condition)->parameters.size() < 2 or ((ASTFunCall *)condition)->parameters.size() > 3) {
+            throw invalid_syntax("Error: Invalid " + construct + " loop, expected (" + construct +
+                                 " (variable begin end [step]) ...). ");
+        }
+        
+        const ASTFunCall & range = *((ASTFunCall *)condition);
+        const ASTNode * begin = range.parameters[0];
+        
+        /* Induction variable is an int unless the initial value is a literal of a different integer type */
+        std::string type = "int";
+        
+        if (begin->nodeType == NodeType::Literal and expr::isNumericalType(((ASTLiteral *)begin)->type) and
+            not expr::isFloatingType(((ASTLiteral *)begin)->type)) {
+            type = ((ASTLiteral *)begin)->type;
+        }
+        
+        _ast.emplaceVariableIntoScope(parameter(range.function, type), _ast.getCurrentScopePtr());
+        
+    }
     
     /* Parse all sexps inside construct body */
     /* All sexps will be emplaced into construct body because emplaceConstruct changes current scope */
@@ -352,6 +609,12 @@ ASTMemberAccess Parser::parseMemberAccess(unsigned long long & exprBeginning) {
             
         }
         
+        /* Elements of struct-of-arrays containers can be indexed using literals, eg. [particles 0 x] */
+        if (isLiteral(exprBeginning)) {
+            accessedMembers.emplace_back(new ASTLiteral(createLiteral(exprBeginning)));
+            continue;
+        }
+        
         if (_tokens[exprBeginning] != tokType::id) {
             throw unexpected_token(_tokens[exprBeginning].value);
         }
@@ -365,6 +628,48 @@ ASTMemberAccess Parser::parseMemberAccess(unsigned long long & exprBeginning) {
     
 }
 
+Options Parser::parseOptions(unsigned long long & iter) {
+    
+    Options options;
+    
+    while (iter < _tokens.size() and _tokens[iter] == tokType::keyword) {
+        
+        /* Remove the colon */
+        const std::string option = _tokens[iter].value.substr(1);
+        std::string value;
+        
+        if (options.count(option)) {
+            throw invalid_syntax("Error: Option :" + option + " is used more than once. ");
+        }
+        
+        /* Some options are followed by an integer value, eg. :unroll 4, tokens following other options */
+        /* aren't consumed, eg. the condition of (while :ivdep 1 ...)                                   */
+        if (expr::isValuedOption(option) and iter + 1 < _tokens.size() and _tokens[iter + 1] == tokType::intLit) {
+            
+            ++iter;
+            value = _tokens[iter].value;
+            
+            /* Remove the ll suffix appended by the tokenizer */
+            if (value.size() > 2 and value.compare(value.size() - 2, 2, "ll") == 0) {
+                value.erase(value.size() - 2);
+            }
+            
+            /* Values are copied into pragmas and attributes, so only plain decimal integers are allowed */
+            if (value.empty() or value.find_first_not_of("0123456789") != std::string::npos) {
+                throw invalid_syntax("Error: Value of option :" + option + " must be a non-negative integer. ");
+            }
+            
+        }
+        
+        options[option] = value;
+        ++iter;
+        
+    }
+    
+    return options;
+    
+}
+
 unsigned long long Parser::findSexpEnd(unsigned long long sexpBeginning) {
     
     unsigned long long sexpEnd = sexpBeginning;
@@ -466,9 +771,41 @@ void Parser::parseFun(unsigned long long funBeginning, unsigned long long funEnd
     
     parseParams(funBeginning + 3, params);
     
+    unsigned long long sexp = 0;
+    
+    /* funBeginning = (; funBeginning + 1 = data type; funBeginning + 2 = name; funBeginning + 3 = ( */
+    /* Find closing paren                                                                            */
+    for (sexp = funBeginning + 3; _tokens[sexp] != tokType::closingPar; ++sexp);
+    /* Next position is either a function option or the opening paren of the first s-expression */
+    ++sexp;
+    
+    /* Function options are written after the parameter list, eg. (int add (int a int b) :export ...) */
+    Options options = parseOptions(sexp);
+    
+    for (const auto & option : options) {
+        
+        if (not expr::isFunctionOption(option.first)) {
+            throw invalid_syntax("Error: Unknown option :" + option.first + " in definition of function " + name + ". ");
+        }
+        
+    }
+    
+    /* Methods are called through vtables, exporting them would only export the mangled name */
+    if (className != "" and options.count("export")) {
+        throw invalid_syntax("Error: Method " + name + " of class " + className + " can't be exported. ");
+    }
+    
+    if (className != "" and options.count("async")) {
+        throw invalid_syntax("Error: Method " + name + " of class " + className + " can't be async. ");
+    }
+    
+    if (name == "main" and options.count("async")) {
+        throw invalid_syntax("Error: Function main can't be async. ");
+    }
+    
     /* Emplace function into ast                                                 */
     /* EmplaceFunction also changes current scope to the newly emplaced function */
-    _ast.emplaceFunction(name, type, params, className);
+    _ast.emplaceFunction(name, type, params, className, options);
     
     for (auto & param : params) {
         
@@ -500,13 +837,6 @@ void Parser::parseFun(unsigned long long funBeginning, unsigned long long funEnd
         _ast.emplaceVariableIntoScope(parameter("self", className + syntax::pointerChar), _ast.getCurrentScopePtr());
     
     }
-    unsigned long long sexp = 0;
-    
-    /* funBeginning = (; funBeginning + 1 = data type; funBeginning + 2 = name; funBeginning + 3 = ( */
-    /* Find closing paren                                                                            */
-    for (sexp = funBeginning + 3; _tokens[sexp] != tokType::closingPar; ++sexp);
-    /* Next position is the opening paren of the first s-expression */
-    ++sexp;
     
     parseSexps(sexp);
     
@@ -518,9 +848,14 @@ void Parser::parseFun(unsigned long long funBeginning, unsigned long long funEnd
 
 void Parser::globalVarDeclaration(unsigned long long declBeginning, unsigned long long declEnd) {
     
-    parameter var = parseVariable(declBeginning);
+    /* Skip qualifiers, eg. (atomic int counter) */
+    unsigned long long typeIndex = declBeginning + 1;
+    type_qualifiers qualifiers = parseQualifiers(typeIndex);
+    
+    parameter var = parseVariable(typeIndex - 1);
+    qualifiers.alignment = var.qualifiers.alignment;
 
-    _ast.emplaceDeclaration(var.type, var.name);
+    _ast.emplaceDeclaration(var.type, var.name, nullptr, qualifiers);
     
 }
 
@@ -573,8 +908,8 @@ void Parser::parseClassMembers(unsigned long long firstSexp, std::string & class
     for (auto sexp : sexps) {
         
         try {
-        /* If token isn't closing paren, it must be an opening parenthesis, which means s-exp is a method */
-            if (_tokens[sexp + 3] != tokType::closingPar) {
+        /* If token isn't closing paren or an option, it must be an opening parenthesis, which means s-exp is a method */
+            if (_tokens[sexp + 3] != tokType::closingPar and _tokens[sexp + 3] != tokType::keyword) {
                 
                 if (_tokens[sexp + 3] != tokType::openingPar) {
                     throw unexpected_token(_tokens[sexp + 3].value);
@@ -618,7 +953,20 @@ parameter Parser::parseVariable(unsigned long long sexpBeginning) {
         throw invalid_declaration("Unknown data type " + param.type);
     }
     
-    if (_tokens[sexpBeginning + 3] != tokType::closingPar) {
+    unsigned long long optionsBeginning = sexpBeginning + 3;
+    Options options = parseOptions(optionsBeginning);
+    
+    for (const auto & option : options) {
+        
+        if (not expr::isVariableOption(option.first)) {
+            throw invalid_syntax("Error: Unknown option :" + option.first + " in declaration of " + param.name + ". ");
+        }
+        
+    }
+    
+    param.qualifiers.alignment = alignmentOption(options, param.name);
+    
+    if (_tokens[optionsBeginning] != tokType::closingPar) {
         
         throw invalid_declaration("Class attributes and global variables can't be initialized with default values. Initialize them using a function. ");
     }
@@ -627,6 +975,23 @@ parameter Parser::parseVariable(unsigned long long sexpBeginning) {
     
 }
 
+size_t Parser::alignmentOption(const Options & options, const std::string & name) {
+    
+    if (not options.count("align")) {
+        return 0;
+    }
+    
+    const std::string & value = options.at("align");
+    const size_t alignment = value == "" ? 0 : std::stoull(value);
+    
+    if (alignment == 0 or (alignment & (alignment - 1)) != 0) {
+        throw invalid_syntax("Error: Alignment of " + name + " must be a power of two. ");
+    }
+    
+    return alignment;
+    
+}
+
 void Parser::classDefinition(unsigned long long defBeginning, unsigned long long defEnd ) {
     
     std::string name = _tokens[defBeginning + 2].value;
@@ -655,14 +1020,27 @@ void Parser::classDefinition(unsigned long long defBeginning, unsigned long long
         superclass = "Object";
     }
     
-    _ast.emplaceClass(name, superclass);
-    
     if (_tokens[firstDeclaration - 1] != tokType::closingPar) {
         
         throw invalid_syntax("Classes can only inherit from 1 superclass. ");
         
     }
     
+    /* Class options are written after the superclass, eg. (class Particle () :pool ...) */
+    Options options = parseOptions(firstDeclaration);
+    
+    for (const auto & option : options) {
+        
+        if (not expr::isClassOption(option.first)) {
+            throw invalid_syntax("Error: Unknown option :" + option.first + " in definition of class " + name + ". ");
+        }
+        
+    }
+    
+    alignmentOption(options, name);
+    
+    _ast.emplaceClass(name, superclass, options);
+    
     parseClassMembers(firstDeclaration, name);
     
     generateVtableInitializer(name);
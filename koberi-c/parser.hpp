@@ -37,9 +37,20 @@ class Parser {
     /* Checks if token at index is a literal */
     bool isLiteral(unsigned long long tokenIndex);
     
+    /* Parses an array declaration, eg. (array int values 16) or (array int values n :heap) */
+    void arrayDeclaration(unsigned long long declBeginning, unsigned long long declEnd);
+    
+    /* Parses a struct-of-arrays container declaration, eg. (soa Particle particles n) */
+    void soaDeclaration(unsigned long long declBeginning, unsigned long long declEnd);
+    
     /* Creates a new literal from a token */
     ASTLiteral createLiteral(unsigned long long literalIndex);
     
+    /* Returns type suffix of a numerical literal, eg. u8 in 5u8, or an empty string */
+    std::string literalSuffix(const std::string & literal);
+    /* Translates a literal with a type suffix into a C literal of the same type */
+    std::string sizedLiteral(const std::string & literal, const std::string & type);
+    
     /* Parses a single s-expression and emplaces it into the AST */
     void parseSexp(unsigned long long sexpBeginning);
     
@@ -55,15 +66,24 @@ class Parser {
     /* and member access parameters aren't parsed as separate variables */
     ASTMemberAccess parseMemberAccess(unsigned long long & exprBeginning);
     
+    /* Parses keyword options, eg. :pool or :unroll 4, starting at index iter        */
+    /* Accepts a reference so when the function execution finishes,                 */
+    /* the iterator points to the first token after the options                     */
+    Options parseOptions(unsigned long long & iter);
+    
     /* Finds index of the end of an s-expression */
     unsigned long long findSexpEnd(unsigned long long sexpBeginning);
     
     /* Parses member functions and class attributes */
     void parseClassMembers(unsigned long long firstSexp, std::string & className);
     
-    /* Parses global functions */
+    /* Parses global variables and class attributes, which may be followed by options, eg. (int hits :align 64) */
     parameter parseVariable(unsigned long long sexpBeginning);
     
+    /* Returns alignment set by the :align option, 0 if the option isn't used */
+    /* Throws if the alignment isn't a power of two                           */
+    size_t alignmentOption(const Options & options, const std::string & name);
+    
     /* Parse sexps finds s-expressions and passes them to parseSexp(), */
     /* a method which parses single s-expressions                      */
     void parseSexps(unsigned long long firstSexp);
@@ -91,6 +111,9 @@ class Parser {
     /* Parses function call parameters */
     void parseParams(unsigned long long beginning, std::vector<parameter> & params);
     
+    /* Parses qualifiers preceding a type, moves iter to the type */
+    type_qualifiers parseQualifiers(unsigned long long & iter);
+    
     /* Iterates over definitions and parses them */
     void parseDefinitions();
     
@@ -0,0 +1,136 @@
+//
+//  profile_data.cpp
+//  koberi-c
+//
+
+#include "profile_data.hpp"
+
+std::string ProfileData::branchKey(const std::string & function, int index) {
+    return function + " " + std::to_string(index);
+}
+
+void ProfileData::load(const std::string & filename) {
+    
+    std::ifstream file(filename);
+    
+    if (not file) {
+        throw file_not_opened(filename);
+    }
+    
+    std::string line;
+    size_t lineNumber = 0;
+    
+    while (std::getline(file, line)) {
+        
+        ++lineNumber;
+        
+        std::stringstream stream(line);
+        std::string kind;
+        std::string name;
+        
+        if (not (stream >> kind) or kind[0] == '#') {
+            continue;
+        }
+        
+        stream >> name;
+        
+        if (kind == "function") {
+            
+            function_profile & profile = _functions[name];
+            
+            if (stream >> profile.calls >> profile.inclusive >> profile.exclusive) {
+                continue;
+            }
+        }
+        
+        else if (kind == "branch") {
+            
+            int index;
+            branch_profile profile;
+            
+            if (stream >> index >> profile.executions >> profile.taken) {
+                _branches[branchKey(name, index)] = profile;
+                continue;
+            }
+        }
+        
+        throw invalid_syntax("Error: Invalid profile data in file " + filename +
+                             " on line " + std::to_string(lineNumber));
+        
+    }
+    
+    findHotFunctions();
+    
+    _isLoaded = true;
+    
+}
+
+void ProfileData::findHotFunctions() {
+    
+    std::vector<std::pair<std::string, uint64_t>> functions;
+    uint64_t total = 0;
+    
+    for (const auto & function : _functions) {
+        functions.emplace_back(function.first, function.second.exclusive);
+        total += function.second.exclusive;
+    }
+    
+    std::sort(functions.begin(), functions.end(), [](const std::pair<std::string, uint64_t> & a,
+                                                     const std::pair<std::string, uint64_t> & b) {
+        return a.second > b.second or (a.second == b.second and a.first < b.first);
+    });
+    
+    uint64_t covered = 0;
+    
+    for (const auto & function : functions) {
+        
+        if (covered >= total * hotShare or function.second == 0) {
+            break;
+        }
+        
+        _hotFunctions.emplace(function.first);
+        covered += function.second;
+        
+    }
+    
+}
+
+bool ProfileData::isLoaded() const {
+    return _isLoaded;
+}
+
+bool ProfileData::isHot(const std::string & function) const {
+    return _hotFunctions.count(function);
+}
+
+bool ProfileData::isCold(const std::string & function) const {
+    return _isLoaded and _functions.count(function) and _functions.at(function).calls == 0;
+}
+
+int ProfileData::expectedBranch(const std::string & function, int index) const {
+    
+    const std::string key = branchKey(function, index);
+    
+    if (not _branches.count(key)) {
+        return -1;
+    }
+    
+    const branch_profile & branch = _branches.at(key);
+    
+    if (branch.executions < minExecutions) {
+        return -1;
+    }
+    
+    const double taken = (double)branch.taken / branch.executions;
+    
+    if (taken >= branchBias) {
+        return 1;
+    }
+    
+    if (taken <= 1 - branchBias) {
+        return 0;
+    }
+    
+    return -1;
+    
+}
@@ -0,0 +1,78 @@
+//
+//  profile_data.hpp
+//  koberi-c
+//
+
+#ifndef profile_data_hpp
+#define profile_data_hpp
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+#include <algorithm>
+#include <cstdint>
+
+#include "exceptions.hpp"
+
+/* Counters collected by a program compiled with --instrument, written at exit of the program */
+/* Functions and branches are identified by mangled function names, branches are numbered   */
+/* in the order if and elif conditions appear in a function                                 */
+/*                                                                                          */
+/* function <mangled name> <calls> <inclusive cycles> <exclusive cycles>                    */
+/* branch <mangled name> <index> <executions> <taken>                                       */
+
+struct function_profile {
+    
+    uint64_t calls = 0;
+    uint64_t inclusive = 0;
+    uint64_t exclusive = 0;
+    
+};
+
+struct branch_profile {
+    
+    uint64_t executions = 0;
+    uint64_t taken = 0;
+    
+};
+
+class ProfileData {
+    
+    std::unordered_map<std::string, function_profile> _functions;
+    std::unordered_map<std::string, branch_profile> _branches;
+    std::unordered_set<std::string> _hotFunctions;
+    
+    bool _isLoaded = false;
+    
+    /* Hot functions together account for this share of self time of the whole program */
+    static constexpr double hotShare = 0.9;
+    /* Branches taken (or not taken) at least this often are marked likely (or unlikely) */
+    static constexpr double branchBias = 0.9;
+    /* Branches executed fewer times don't provide enough information */
+    static const uint64_t minExecutions = 16;
+    
+    static std::string branchKey(const std::string & function, int index);
+    
+    /* Marks functions with the most self time as hot */
+    void findHotFunctions();
+    
+public:
+    
+    /* Reads counters from a profile, throws if the file can't be read or is malformed */
+    void load(const std::string & filename);
+    
+    bool isLoaded() const;
+    
+    /* Functions listed in the profile with zero calls are cold, functions missing from the profile are neither */
+    bool isHot(const std::string & function) const;
+    bool isCold(const std::string & function) const;
+    
+    /* Returns 1 if branch is likely taken, 0 if it's unlikely taken and -1 if it isn't biased */
+    int expectedBranch(const std::string & function, int index) const;
+    
+};
+
+#endif /* profile_data_hpp */
@@ -12,6 +12,7 @@
 #include <string>
 #include <unordered_map>
 #include <array>
+#include <utility>
 
 /* Namespace which holds information regarding basic Kobeři-C syntax */
 
@@ -32,14 +33,88 @@ namespace syntax {
     const std::string intType = "int_type";
     const std::string uintType = "uint_type";
     
+    /* Holds C types for fixed width Kobeři-C data types */
+    const std::unordered_map<std::string /* Kobeři-C type */, std::string /* C type */> sizedTypes = {
+        
+        {"i8", "int8_t"}, {"i16", "int16_t"}, {"i32", "int32_t"}, {"i64", "int64_t"},
+        {"u8", "uint8_t"}, {"u16", "uint16_t"}, {"u32", "uint32_t"}, {"u64", "uint64_t"},
+        {"f32", "float"}, {"f64", "double"}
+        
+    };
+    
+    /* Holds element types and lane counts of SIMD vector types, translated to GCC/Clang vector extensions */
+    const std::unordered_map<std::string /* Kobeři-C type */, std::pair<std::string /* element */, int /* lanes */>>
+    vectorTypes = {
+        
+        {"f32x4", {"f32", 4}}, {"f32x8", {"f32", 8}}, {"f64x2", {"f64", 2}}, {"f64x4", {"f64", 4}},
+        {"i32x4", {"i32", 4}}, {"i32x8", {"i32", 8}}, {"i64x2", {"i64", 2}}, {"i64x4", {"i64", 4}},
+        {"u32x4", {"u32", 4}}, {"u32x8", {"u32", 8}}, {"i16x8", {"i16", 8}}, {"u8x16", {"u8", 16}}
+        
+    };
+    
+    /* Suffix of C typedefs of vector types, eg. f64x4_type */
+    const std::string vectorTypeSuffix = "_type";
+    
+    /* Macros used to implement vector builtins */
+    const std::string vectorLoad = "_vec_load";
+    const std::string vectorStore = "_vec_store";
+    const std::string vectorSplat = "_vec_splat";
+    const std::string vectorShuffle = "_vec_shuffle";
+    const std::string vectorReduce = "_vec_reduce";
+    
+    /* Prefix of helpers implementing clz and ctz, which are defined for zero, eg. _bits_clz64 */
+    const std::string countLeadingZeros = "_bits_clz";
+    const std::string countTrailingZeros = "_bits_ctz";
+    
+    /* Macros which combine two lanes in reductions */
+    const std::unordered_map<std::string /* Kobeři-C builtin */, std::string /* C macro */> vectorReductions = {
+        
+        {"vec_reduce_add", "_vec_add"}, {"vec_reduce_min", "_vec_min"}, {"vec_reduce_max", "_vec_max"}
+        
+    };
+    
+    /* Struct-of-arrays containers of class Particle are of type Particle_soa */
+    /* The struct holds number of elements and one array per attribute        */
+    const std::string soaSuffix = "_soa";
+    const std::string soaLength = "_length";
+    
     /* Vtable initializer method name */
     const std::string vtableInit = "_vtable_init";
     
     /* Object memory allocator/vtable initializer function */
     const std::string memoryAlloc = "_mem_allocator";
+    const std::string alignedMemoryAlloc = "_mem_aligned_allocator";
+    
+    /* Pool allocator runtime - releases pooled objects of any class, prints pool statistics */
+    const std::string poolRelease = "_pool_release";
+    const std::string poolStats = "_pool_stats";
+    
+    /* Profiling runtime - function entry/exit hooks and the profile printed at exit */
+    const std::string profileEntry = "_prof_entry";
+    const std::string profileFrame = "_prof_frame";
+    const std::string profileEnter = "_prof_enter";
+    const std::string profileExit = "_prof_exit";
+    const std::string profileBranch = "_prof_branch";
+    const std::string profileDump = "_prof_dump";
+    
+    /* Task runtime - spawned tasks, groups of tasks spawned by a function and their synchronization */
+    const std::string taskType = "_task";
+    const std::string taskGroup = "_task_group";
+    const std::string taskSpawn = "_task_spawn";
+    const std::string taskSync = "_task_sync";
+    /* Group of tasks spawned by the current function, synced when the function returns */
+    const std::string taskGroupVariable = "_tasks__";
     
-    /* Copy object function */
-    const std::string copyObject = "_copy_object";
+    /* Coroutine runtime - header of coroutine frames, resuming coroutines and checking if they finished */
+    const std::string coroutine = "coroutine";
+    const std::string coroutineType = "_coroutine";
+    const std::string coroutineResume = "_co_resume";
+    const std::string coroutineDone = "_co_done";
+    /* Coroutine being resumed and it's frame, accessible inside resume functions */
+    const std::string coroutineVariable = "_co__coroutine";
+    const std::string coroutineFrameVariable = "_co__frame";
+    /* Value returned by a coroutine, stored in it's frame */
+    const std::string coroutineResult = "_co__result";
     
     /* Character used to declare pointers */
     const char pointerChar = '*';
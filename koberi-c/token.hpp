@@ -23,6 +23,7 @@ enum class tokType {
     strLit,         //  String literal, eg. "Kobeřice"
     id,             //  An identifier, eg. add
     op,             //  An operator, eg. +
+    keyword,        //  A keyword option, eg. :pool
     none            //  Nothing
     
 };
@@ -109,6 +109,26 @@ void Tokenizer::numberLiteral() {
     
     if (str.back() == '.') { throw unexpected_token('.'); }
     
+    /* Literals may end with a type suffix, eg. 5u8 or 2.5f32 */
+    if ( syntax::isValidIdChar(_line[_iter]) ) {
+        
+        std::string suffix;
+        
+        while ( syntax::isValidIdChar(_line[_iter]) or syntax::isNum(_line[_iter]) ) {
+            suffix += std::string(1, _line[_iter]); /* std::string constructor(repeat: int, character: char) */
+            ++_iter;
+        }
+        
+        /* Floating point literals can't be converted to integer types implicitly */
+        if (not syntax::sizedTypes.count(suffix) or (isNum and suffix.front() != 'f')) {
+            throw invalid_syntax("Error: Invalid suffix " + suffix + " of literal " + str + ". ");
+        }
+        
+        _tokens.emplace_back(isNum ? tokType::numLit : tokType::intLit, str + suffix);
+        return;
+        
+    }
+    
     if (isNum) {
         _tokens.emplace_back(tokType::numLit, str);
     } else {
@@ -117,6 +137,24 @@ void Tokenizer::numberLiteral() {
     
 }
 
+void Tokenizer::keyword() {
+    
+    std::string str(1, _line[_iter]); /* std::string constructor(repeat: int, character: char) */
+    ++_iter;
+    
+    while ( syntax::isValidIdChar(_line[_iter]) or syntax::isNum(_line[_iter]) ) {
+        
+        str += std::string(1, _line[_iter]); /* std::string constructor(repeat: int, character: char) */
+        ++_iter;
+        
+    }
+    
+    /* A colon must be followed by the name of the option */
+    if (str.length() == 1) { throw unexpected_token(':'); }
+    
+    _tokens.emplace_back(tokType::keyword, str);
+    
+}
 
 void Tokenizer::strLiteral(const char delimiter) {
     
@@ -212,6 +250,9 @@ void Tokenizer::parseLine() {
         /* Check for operator */
         else if ( syntax::isOperatorChar(_line[_iter]) ) {  operatorCheck();  }
         
+        /* Check for a keyword option */
+        else if ( _line[_iter] == ':' ) {  keyword();  }
+        
         /* Check for a character */
         else if ( _line[_iter] == '\'' ) { strLiteral('\''); }
         
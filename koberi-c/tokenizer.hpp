@@ -44,6 +44,8 @@ class Tokenizer {
     void operatorCheck();
     /* Lexes numerical literals */
     void numberLiteral();
+    /* Lexes keyword options, eg. :pool */
+    void keyword();
     /* Tokenizes and lexes char and string literals */
     void strLiteral(const char delimiter='"');
     /* Reads a single line from input stream */
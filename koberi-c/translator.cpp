@@ -36,6 +36,67 @@ void Translator::typedefs() {
     
 }
 
+void Translator::bitCounts() {
+    
+    if (not _ast.usesBitCounts()) {
+        return;
+    }
+    
+    _output << "\n" << "/* Bit counting */" << "\n\n";
+    
+    /* GCC builtins are undefined for zero, the helpers return the number of bits instead */
+    for (const std::string & width : { "32", "64" }) {
+        
+        const std::string suffix = width == "64" ? "ll" : "";
+        
+        _output << "static inline int " << syntax::countLeadingZeros << width << "(uint" << width << "_t x) { "
+                << "return x ? __builtin_clz" << suffix << "(x) : " << width << "; }" << "\n";
+        _output << "static inline int " << syntax::countTrailingZeros << width << "(uint" << width << "_t x) { "
+                << "return x ? __builtin_ctz" << suffix << "(x) : " << width << "; }" << "\n";
+    }
+    
+}
+
+void Translator::vectorTypes() {
+    
+    /* Vector macros use GNU extensions, programs without vectors shouldn't require them */
+    if (not _ast.usesVectors()) {
+        return;
+    }
+    
+    _output << "\n" << "/* SIMD vectors */" << "\n\n";
+    
+    /* Sorted, so the output doesn't depend on hash map order */
+    const std::map<std::string, std::pair<std::string, int>> types(syntax::vectorTypes.begin(),
+                                                                   syntax::vectorTypes.end());
+    
+    for (auto & type : types) {
+        
+        const std::string element = translateType(type.second.first);
+        
+        _output << "typedef " << element << " " << translateType(type.first) << " __attribute__((vector_size("
+                << type.second.second << " * sizeof(" << element << "))));" << "\n";
+    }
+    
+    /* Loads and stores don't require aligned memory, memcpy compiles to a single unaligned move */
+    _output << "\n";
+    _output << "#define " << syntax::vectorLoad << "(T, p) ({ T _vec__; memcpy(&_vec__, (p), sizeof(_vec__)); _vec__; })"
+            << "\n";
+    _output << "#define " << syntax::vectorStore << "(p, v) "
+            << "({ __typeof__(v) _vec__ = (v); (void)memcpy((p), &_vec__, sizeof(_vec__)); })" << "\n";
+    _output << "#define " << syntax::vectorSplat << "(T, x) ((T){ 0 } + (x))" << "\n";
+    _output << "#define " << syntax::vectorShuffle << "(v, ...) "
+            << "({ __typeof__(v) _vec__ = (v); __builtin_shufflevector(_vec__, _vec__, __VA_ARGS__); })" << "\n";
+    _output << "#define " << syntax::vectorReduce << "(v, combine) "
+            << "({ __typeof__(v) _vec__ = (v); __typeof__(_vec__[0]) _red__ = _vec__[0]; "
+            << "for (int _i__ = 1; _i__ < (int)(sizeof(_vec__) / sizeof(_red__)); ++_i__) { "
+            << "_red__ = combine(_red__, _vec__[_i__]); } _red__; })" << "\n";
+    _output << "#define _vec_add(a, b) ((a) + (b))" << "\n";
+    _output << "#define _vec_min(a, b) ((b) < (a) ? (b) : (a))" << "\n";
+    _output << "#define _vec_max(a, b) ((b) > (a) ? (b) : (a))" << "\n";
+    
+}
+
 void Translator::translateClasses() {
     
     const std::vector<AASTClass *> & classes = _aast.getClasses();
@@ -86,7 +147,9 @@ void Translator::translateVtables() {
     
     for (const AASTClass * c : classes) {
         
-        _output << c->vtable() << ";\n" << std::endl;
+        if (c->isInstantiated()) {
+            _output << c->vtable() << ";\n" << std::endl;
+        }
         
     }
     
@@ -96,7 +159,12 @@ void Translator::translateFunctions() {
     
     _output << "\n\n" << "/* Function Definitionss */" << "\n\n";
     
-    const std::vector<AASTFunction *> & functions = _aast.getFunctions();
+    /* Hot functions are placed next to each other and cold functions last, so hot code shares */
+    /* instruction cache lines and pages                                                      */
+    std::vector<AASTFunction *> functions = _aast.getFunctions();
+    
+    std::stable_partition(functions.begin(), functions.end(), [](AASTFunction * f) { return not f->isCold(); });
+    std::stable_partition(functions.begin(), functions.end(), [](AASTFunction * f) { return f->isHot(); });
     
     for (AASTFunction * function : functions) {
         _output << function->value() << "\n" << std::endl;
@@ -108,7 +176,7 @@ void Translator::memoryAllocator() {
     
     _output << "\n" << "/* Memory allocator */" << "\n" << "\n";
     
-    _output << "void* " << syntax::memoryAlloc << "(" << syntax::intType
+    _output << "static inline void* " << syntax::memoryAlloc << "(" << syntax::intType
             << " size, void* (*fun)(void*)) {" << "\n";
     
     _output << INDENT << "void * object = malloc(size);" << "\n";
@@ -119,26 +187,687 @@ void Translator::memoryAllocator() {
     
     _output << INDENT << "return object;" << "\n";
     
+    _output << "}" << "\n" << "\n";
+    
+    /* Objects of classes using :align, sizeof is always a multiple of the alignment */
+    _output << "static inline void* " << syntax::alignedMemoryAlloc << "(" << syntax::intType
+            << " size, " << syntax::intType << " alignment, void* (*fun)(void*)) {" << "\n";
+    
+    _output << INDENT << "void * object = aligned_alloc(alignment, size);" << "\n";
+    
+    _output << INDENT << "if (fun) {" << "\n";
+    _output << INDENT << INDENT << "fun(object);" << "\n";
+    _output << INDENT << "}" << "\n";
+    
+    _output << INDENT << "return object;" << "\n";
+    
+    _output << "}" << std::endl;
+    
+}
+
+void Translator::coroutineRuntime() {
+    
+    if (not _aast.usesCoroutines()) {
+        return;
+    }
+    
+    const std::string & coroutine = syntax::coroutineType;
+    const std::string intType = translateType("int");
+    
+    _output << "\n\n" << "/* Coroutines */" << "\n\n";
+    
+    /* State is the index of the suspension point to continue from, 0 before start and -1 after finishing */
+    /* Awaited is the coroutine the coroutine is waiting for                                            */
+    _output << "typedef struct " << coroutine << " {" << "\n";
+    _output << INDENT << intType << " state;" << "\n";
+    _output << INDENT << intType << " (*resume)(struct " << coroutine << " *);" << "\n";
+    _output << INDENT << "struct " << coroutine << " * awaited;" << "\n";
+    _output << "} " << coroutine << ";" << "\n\n";
+    
+    /* Returns 1 if the coroutine suspended again, 0 if it finished */
+    _output << "static inline " << intType << " " << syntax::coroutineResume << "(" << coroutine
+            << " * coroutine) {" << "\n";
+    _output << INDENT << "return coroutine->state >= 0 && coroutine->resume(coroutine);" << "\n";
+    _output << "}" << "\n\n";
+    
+    _output << "static inline " << intType << " " << syntax::coroutineDone << "(" << coroutine
+            << " * coroutine) {" << "\n";
+    _output << INDENT << "return coroutine->state < 0;" << "\n";
+    _output << "}" << std::endl;
+    
+}
+
+void Translator::coroutineFrames() {
+    
+    if (not _aast.usesCoroutines()) {
+        return;
+    }
+    
+    _output << "\n\n" << "/* Coroutine Frames */" << "\n\n";
+    
+    for (AASTFunction * function : _aast.getFunctions()) {
+        
+        if (function->isAsync()) {
+            _output << function->frame() << "\n";
+        }
+        
+    }
+    
+}
+
+void Translator::taskScheduler() {
+    
+    if (not _aast.spawnsTasks()) {
+        return;
+    }
+    
+    const std::string & task = syntax::taskType;
+    const std::string & group = syntax::taskGroup;
+    
+    _output << "\n\n" << "/* Task scheduler */" << "\n\n";
+    
+    /* Group of tasks spawned by a single function call, pending is the number of unfinished tasks */
+    _output << "typedef struct " << group << " {" << "\n";
+    _output << INDENT << "size_t pending;" << "\n";
+    _output << "} " << group << ";" << "\n\n";
+    
+    /* Tasks of spawned functions start with this header, followed by parameters of the function */
+    _output << "typedef struct " << task << " {" << "\n";
+    _output << INDENT << "void (*run)(struct " << task << " *);" << "\n";
+    _output << INDENT << group << " * group;" << "\n";
+    _output << "} " << task << ";" << "\n\n";
+    
+    /* Ring buffer, top and bottom only grow, capacity is a power of two so indices can wrap around */
+    _output << "typedef struct _task_deque {" << "\n";
+    _output << INDENT << "pthread_mutex_t lock;" << "\n";
+    _output << INDENT << task << " ** tasks;" << "\n";
+    _output << INDENT << "size_t capacity;" << "\n";
+    _output << INDENT << "size_t top;" << "\n";
+    _output << INDENT << "size_t bottom;" << "\n";
+    _output << "} _task_deque;" << "\n\n";
+    
+    _output << "static _task_deque * _task__deques = NULL;" << "\n";
+    _output << "static long _task__workers = 1;" << "\n";
+    _output << "static size_t _task__queued = 0;" << "\n";
+    _output << "static size_t _task__sleeping = 0;" << "\n";
+    _output << "static pthread_mutex_t _task__idleLock = PTHREAD_MUTEX_INITIALIZER;" << "\n";
+    _output << "static pthread_cond_t _task__idle = PTHREAD_COND_INITIALIZER;" << "\n";
+    _output << "static pthread_once_t _task__once = PTHREAD_ONCE_INIT;" << "\n";
+    _output << "static _Thread_local long _task__worker = 0;" << "\n\n";
+    
+    /* Returns 0 if the deque can't grow, the task is then run immediately by the spawning worker */
+    _output << "static int _task_push(_task_deque * deque, " << task << " * task) {" << "\n\n";
+    _output << INDENT << "pthread_mutex_lock(&deque->lock);" << "\n\n";
+    _output << INDENT << "if (deque->bottom - deque->top == deque->capacity) {" << "\n\n";
+    _output << INDENT << INDENT << "size_t capacity = deque->capacity ? deque->capacity * 2 : 64;" << "\n";
+    _output << INDENT << INDENT << task << " ** tasks = malloc(capacity * sizeof(" << task << " *));" << "\n";
+    _output << INDENT << INDENT << "if (!tasks) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "pthread_mutex_unlock(&deque->lock);" << "\n";
+    _output << INDENT << INDENT << INDENT << "return 0;" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << INDENT << "for (size_t i = deque->top; i != deque->bottom; ++i) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "tasks[i % capacity] = deque->tasks[i % deque->capacity];" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << INDENT << "free(deque->tasks);" << "\n";
+    _output << INDENT << INDENT << "deque->tasks = tasks;" << "\n";
+    _output << INDENT << INDENT << "deque->capacity = capacity;" << "\n\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "deque->tasks[deque->bottom % deque->capacity] = task;" << "\n";
+    _output << INDENT << "deque->bottom += 1;" << "\n\n";
+    _output << INDENT << "pthread_mutex_unlock(&deque->lock);" << "\n";
+    _output << INDENT << "return 1;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* Owner takes the newest task, which is likely still in cache, thieves take the oldest task, */
+    /* which usually represents the largest amount of work in divide and conquer algorithms       */
+    _output << "static " << task << " * _task_pop(_task_deque * deque, int steal) {" << "\n\n";
+    _output << INDENT << task << " * task = NULL;" << "\n\n";
+    _output << INDENT << "pthread_mutex_lock(&deque->lock);" << "\n\n";
+    _output << INDENT << "if (deque->top != deque->bottom && steal) {" << "\n";
+    _output << INDENT << INDENT << "task = deque->tasks[deque->top % deque->capacity];" << "\n";
+    _output << INDENT << INDENT << "deque->top += 1;" << "\n";
+    _output << INDENT << "} else if (deque->top != deque->bottom) {" << "\n";
+    _output << INDENT << INDENT << "deque->bottom -= 1;" << "\n";
+    _output << INDENT << INDENT << "task = deque->tasks[deque->bottom % deque->capacity];" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "pthread_mutex_unlock(&deque->lock);" << "\n";
+    _output << INDENT << "return task;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    _output << "static " << task << " * _task_take(void) {" << "\n\n";
+    _output << INDENT << task << " * task = _task_pop(&_task__deques[_task__worker], 0);" << "\n\n";
+    _output << INDENT << "for (long i = 1; !task && i < _task__workers; ++i) {" << "\n";
+    _output << INDENT << INDENT << "task = _task_pop(&_task__deques[(_task__worker + i) % _task__workers], 1);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "if (task) {" << "\n";
+    _output << INDENT << INDENT << "__atomic_sub_fetch(&_task__queued, 1, __ATOMIC_SEQ_CST);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "return task;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* The group lives on the stack of the spawning function, it mustn't be accessed after the decrement */
+    _output << "static void _task_run(" << task << " * task) {" << "\n\n";
+    _output << INDENT << group << " * group = task->group;" << "\n\n";
+    _output << INDENT << "task->run(task);" << "\n";
+    _output << INDENT << "free(task);" << "\n\n";
+    _output << INDENT << "__atomic_sub_fetch(&group->pending, 1, __ATOMIC_RELEASE);" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* Workers announce they're going to sleep before checking for tasks, spawn checks for sleeping */
+    /* workers after queueing a task, so either the worker sees the task or it's woken up          */
+    _output << "static void * _task_worker(void * worker) {" << "\n\n";
+    _output << INDENT << "_task__worker = (long)(intptr_t)worker;" << "\n\n";
+    _output << INDENT << "for (;;) {" << "\n\n";
+    _output << INDENT << INDENT << task << " * task = _task_take();" << "\n\n";
+    _output << INDENT << INDENT << "if (task) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "_task_run(task);" << "\n";
+    _output << INDENT << INDENT << INDENT << "continue;" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << INDENT << "pthread_mutex_lock(&_task__idleLock);" << "\n";
+    _output << INDENT << INDENT << "__atomic_add_fetch(&_task__sleeping, 1, __ATOMIC_SEQ_CST);" << "\n\n";
+    _output << INDENT << INDENT << "while (!__atomic_load_n(&_task__queued, __ATOMIC_SEQ_CST)) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "pthread_cond_wait(&_task__idle, &_task__idleLock);" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << INDENT << "__atomic_sub_fetch(&_task__sleeping, 1, __ATOMIC_SEQ_CST);" << "\n";
+    _output << INDENT << INDENT << "pthread_mutex_unlock(&_task__idleLock);" << "\n\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "return NULL;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* The thread which spawns the first task becomes worker 0, other workers are started here */
+    _output << "static void _task_start(void) {" << "\n\n";
+    _output << INDENT << "const char * env = getenv(\"KOBERIC_WORKERS\");" << "\n";
+    _output << INDENT << "long workers = env ? strtol(env, NULL, 10) : sysconf(_SC_NPROCESSORS_ONLN);" << "\n\n";
+    _output << INDENT << "if (workers < 1) {" << "\n";
+    _output << INDENT << INDENT << "workers = 1;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "_task__deques = calloc(workers, sizeof(_task_deque));" << "\n";
+    _output << INDENT << "if (!_task__deques) {" << "\n";
+    _output << INDENT << INDENT << "fputs(\"Task scheduler: out of memory\\n\", stderr);" << "\n";
+    _output << INDENT << INDENT << "exit(EXIT_FAILURE);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "for (long i = 0; i < workers; ++i) {" << "\n";
+    _output << INDENT << INDENT << "pthread_mutex_init(&_task__deques[i].lock, NULL);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "_task__workers = workers;" << "\n\n";
+    _output << INDENT << "/* Deques of workers which couldn't be started stay empty */" << "\n";
+    _output << INDENT << "for (long i = 1; i < workers; ++i) {" << "\n\n";
+    _output << INDENT << INDENT << "pthread_t thread;" << "\n\n";
+    _output << INDENT << INDENT << "if (pthread_create(&thread, NULL, _task_worker, (void *)(intptr_t)i)) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "break;" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << INDENT << "pthread_detach(thread);" << "\n\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    _output << "static void " << syntax::taskSpawn << "(" << group << " * group, " << task << " * task, void (*run)("
+            << task << " *)) {" << "\n\n";
+    _output << INDENT << "pthread_once(&_task__once, _task_start);" << "\n\n";
+    _output << INDENT << "task->run = run;" << "\n";
+    _output << INDENT << "task->group = group;" << "\n";
+    _output << INDENT << "__atomic_add_fetch(&group->pending, 1, __ATOMIC_RELAXED);" << "\n\n";
+    _output << INDENT << "/* Counted before the push, so a thief never decrements the counter below zero */" << "\n";
+    _output << INDENT << "__atomic_add_fetch(&_task__queued, 1, __ATOMIC_SEQ_CST);" << "\n\n";
+    _output << INDENT << "if (!_task_push(&_task__deques[_task__worker], task)) {" << "\n";
+    _output << INDENT << INDENT << "__atomic_sub_fetch(&_task__queued, 1, __ATOMIC_SEQ_CST);" << "\n";
+    _output << INDENT << INDENT << "_task_run(task);" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "if (__atomic_load_n(&_task__sleeping, __ATOMIC_SEQ_CST)) {" << "\n";
+    _output << INDENT << INDENT << "pthread_mutex_lock(&_task__idleLock);" << "\n";
+    _output << INDENT << INDENT << "pthread_cond_signal(&_task__idle);" << "\n";
+    _output << INDENT << INDENT << "pthread_mutex_unlock(&_task__idleLock);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* Waiting worker runs queued tasks, so it never blocks while there's work left */
+    _output << "static void " << syntax::taskSync << "(" << group << " * group) {" << "\n\n";
+    _output << INDENT << "while (__atomic_load_n(&group->pending, __ATOMIC_ACQUIRE)) {" << "\n\n";
+    _output << INDENT << INDENT << task << " * task = _task_take();" << "\n\n";
+    _output << INDENT << INDENT << "if (task) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "_task_run(task);" << "\n";
+    _output << INDENT << INDENT << "} else {" << "\n";
+    _output << INDENT << INDENT << INDENT << "sched_yield();" << "\n";
+    _output << INDENT << INDENT << "}" << "\n\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << "}" << std::endl;
+    
+}
+
+void Translator::taskFunctions() {
+    
+    if (_aast.getSpawnedFunctions().empty()) {
+        return;
+    }
+    
+    _output << "\n\n" << "/* Spawned functions */" << "\n\n";
+    
+    /* Spawned functions may have been removed if the functions which spawn them are unreachable */
+    std::set<std::string> functions;
+    for (AASTFunction * function : _aast.getFunctions()) {
+        functions.emplace(function->getName());
+    }
+    
+    for (const spawned_function & function : _aast.getSpawnedFunctions()) {
+        
+        if (not functions.count(function.name)) {
+            continue;
+        }
+        
+        const std::string task = NameMangler::taskName(function.name);
+        const std::string run = NameMangler::taskRunName(function.name);
+        const bool hasResult = function.type != "void";
+        
+        std::string parameters;
+        std::string arguments;
+        std::string taskArguments;
+        
+        for (size_t i = 0; i < function.parameters.size(); ++i) {
+            
+            const std::string separator = i ? ", " : "";
+            const std::string name = "p" + std::to_string(i);
+            
+            parameters += ", " + translateType(function.parameters[i]) + " " + name;
+            arguments += separator + name;
+            taskArguments += separator + "task->" + name;
+        }
+        
+        _output << "typedef struct " << task << " {" << "\n";
+        _output << INDENT << syntax::taskType << " header;" << "\n";
+        if (hasResult) {
+            _output << INDENT << translateType(function.type) << " * result;" << "\n";
+        }
+        for (size_t i = 0; i < function.parameters.size(); ++i) {
+            _output << INDENT << translateType(function.parameters[i]) << " p" << i << ";" << "\n";
+        }
+        _output << "} " << task << ";" << "\n\n";
+        
+        _output << "static void " << run << "(" << syntax::taskType << " * header) {" << "\n";
+        _output << INDENT << task << " * task = (" << task << " *)header;" << "\n";
+        if (hasResult) {
+            _output << INDENT << "if (task->result) {" << "\n";
+            _output << INDENT << INDENT << "*task->result = " << function.name << "(" << taskArguments << ");" << "\n";
+            _output << INDENT << "} else {" << "\n";
+            _output << INDENT << INDENT << function.name << "(" << taskArguments << ");" << "\n";
+            _output << INDENT << "}" << "\n";
+        } else {
+            _output << INDENT << function.name << "(" << taskArguments << ");" << "\n";
+        }
+        _output << "}" << "\n\n";
+        
+        _output << "static inline void " << NameMangler::taskSpawnName(function.name) << "(" << syntax::taskGroup
+                << " * group" << (hasResult ? ", " + translateType(function.type) + " * result" : "")
+                << parameters << ") {" << "\n\n";
+        _output << INDENT << task << " * task = malloc(sizeof(" << task << "));" << "\n\n";
+        _output << INDENT << "/* Function is called directly if there isn't enough memory for a task */" << "\n";
+        _output << INDENT << "if (!task) {" << "\n";
+        if (hasResult) {
+            _output << INDENT << INDENT << "if (result) {" << "\n";
+            _output << INDENT << INDENT << INDENT << "*result = " << function.name << "(" << arguments << ");" << "\n";
+            _output << INDENT << INDENT << "} else {" << "\n";
+            _output << INDENT << INDENT << INDENT << function.name << "(" << arguments << ");" << "\n";
+            _output << INDENT << INDENT << "}" << "\n";
+        } else {
+            _output << INDENT << INDENT << function.name << "(" << arguments << ");" << "\n";
+        }
+        _output << INDENT << INDENT << "return;" << "\n";
+        _output << INDENT << "}" << "\n\n";
+        if (hasResult) {
+            _output << INDENT << "task->result = result;" << "\n";
+        }
+        for (size_t i = 0; i < function.parameters.size(); ++i) {
+            _output << INDENT << "task->p" << i << " = p" << i << ";" << "\n";
+        }
+        _output << INDENT << syntax::taskSpawn << "(group, &task->header, " << run << ");" << "\n\n";
+        _output << "}" << "\n\n";
+        
+    }
+    
+}
+
+void Translator::objectCopyFunctions() {
+    
+    _output << "\n" << "/* Object copy functions - copy objects and preserve vtable ptrs */" << "\n\n";
+    
+    for (const AASTClass * c : _aast.getClasses()) {
+        
+        const std::string cls = c->type();
+        
+        _output << "static inline void " << NameMangler::copyFunctionName(cls) << "(" << cls
+                << " * dest, const " << cls << " * orig) {" << "\n";
+        
+        for (const parameter & att : _ast.getClass(cls).attributes) {
+            
+            /* Attribute objects keep their vtables as well */
+            if (not syntax::isPointerType(att.type) and _ast.isClass(att.type)) {
+                _output << INDENT << NameMangler::copyFunctionName(att.type) << "(&dest->" << att.name
+                        << ", &orig->" << att.name << ");" << "\n";
+            } else {
+                _output << INDENT << "dest->" << att.name << " = orig->" << att.name << ";" << "\n";
+            }
+            
+        }
+        
+        _output << "}" << "\n\n";
+        
+    }
+    
+}
+
+std::vector<std::string> Translator::pooledClasses() {
+    
+    std::vector<std::string> pooled;
+    
+    /* Classes which are never instantiated don't need a pool */
+    for (const AASTClass * c : _aast.getClasses()) {
+        if (c->isInstantiated() and _ast.isPooled(c->type())) {
+            pooled.emplace_back(c->type());
+        }
+    }
+    
+    return pooled;
+    
+}
+
+void Translator::poolAllocators() {
+    
+    const std::vector<std::string> pooled = pooledClasses();
+    
+    if (pooled.empty()) {
+        return;
+    }
+    
+    _output << "\n\n" << "/* Pool allocators */" << "\n\n";
+    
+    /* Free objects form a singly linked list, the link is stored in place of the object */
+    _output << "typedef struct _pool {" << "\n";
+    _output << INDENT << "void * freeList;" << "\n";
+    _output << INDENT << "size_t objectSize;" << "\n";
+    _output << INDENT << "size_t slabSize;" << "\n";
+    _output << INDENT << "const char * className;" << "\n";
+    _output << INDENT << "size_t allocations;" << "\n";
+    _output << INDENT << "size_t releases;" << "\n";
+    _output << INDENT << "size_t slabs;" << "\n";
+    _output << INDENT << "size_t inUse;" << "\n";
+    _output << INDENT << "size_t peak;" << "\n";
+    _output << "} _pool;" << "\n\n";
+    
+    /* Allocates a new slab and threads all of it's objects onto the free list */
+    _output << "static void _pool_refill(_pool * pool) {" << "\n\n";
+    _output << INDENT << "char * slab = malloc(pool->objectSize * pool->slabSize);" << "\n";
+    _output << INDENT << "if (!slab) {" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "for (size_t i = 0; i < pool->slabSize; ++i) {" << "\n";
+    _output << INDENT << INDENT << "void ** object = (void**)(slab + i * pool->objectSize);" << "\n";
+    _output << INDENT << INDENT << "*object = pool->freeList;" << "\n";
+    _output << INDENT << INDENT << "pool->freeList = object;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "pool->slabs += 1;" << "\n";
+    _output << INDENT << "if (pool->slabSize < 4096) {" << "\n";
+    _output << INDENT << INDENT << "pool->slabSize *= 2;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    _output << "static inline void * _pool_alloc(_pool * pool) {" << "\n\n";
+    _output << INDENT << "if (!pool->freeList) {" << "\n";
+    _output << INDENT << INDENT << "_pool_refill(pool);" << "\n";
+    _output << INDENT << INDENT << "if (!pool->freeList) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "return NULL;" << "\n";
+    _output << INDENT << INDENT << "}" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "void ** object = pool->freeList;" << "\n";
+    _output << INDENT << "pool->freeList = *object;" << "\n\n";
+    _output << INDENT << "pool->allocations += 1;" << "\n";
+    _output << INDENT << "pool->inUse += 1;" << "\n";
+    _output << INDENT << "if (pool->inUse > pool->peak) {" << "\n";
+    _output << INDENT << INDENT << "pool->peak = pool->inUse;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "return object;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    _output << "static inline void _pool_free(_pool * pool, void * object) {" << "\n\n";
+    _output << INDENT << "if (!object) {" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "*(void**)object = pool->freeList;" << "\n";
+    _output << INDENT << "pool->freeList = object;" << "\n\n";
+    _output << INDENT << "pool->releases += 1;" << "\n";
+    _output << INDENT << "pool->inUse -= 1;" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    for (const std::string & cls : pooled) {
+        
+        const std::string pool = NameMangler::poolName(cls);
+        
+        _output << "static _pool " << pool << " = { NULL, sizeof(" << cls << "), 64, \"" << cls
+                << "\", 0, 0, 0, 0, 0 };" << "\n\n";
+        
+        /* Vtable pointer is stored directly, only by-value attributes need their initializers */
+        _output << "static inline " << cls << "* " << NameMangler::poolAllocatorName(cls) << "(void) {" << "\n\n";
+        _output << INDENT << cls << " * object = _pool_alloc(&" << pool << ");" << "\n";
+        _output << INDENT << "if (!object) {" << "\n";
+        _output << INDENT << INDENT << "return NULL;" << "\n";
+        _output << INDENT << "}" << "\n\n";
+        _output << INDENT << "object->vtable = " << NameMangler::vtableName(cls) << ";" << "\n";
+        
+        for (const parameter & att : _ast.getClass(cls).attributes) {
+            
+            if (not syntax::isPointerType(att.type) and _ast.isClass(att.type)) {
+                
+                std::string vtInitializer = NameMangler::mangleName(syntax::vtableInit,
+                                                                    std::vector<std::string>());
+                vtInitializer = NameMangler::premangleMethodName(vtInitializer, att.type);
+                
+                _output << INDENT << vtInitializer << "(&object->" << att.name << ");" << "\n";
+            }
+            
+        }
+        
+        _output << "\n" << INDENT << "return object;" << "\n\n";
+        _output << "}" << "\n\n";
+        
+        _output << "static inline void " << NameMangler::poolDeallocatorName(cls) << "(void * object) {" << "\n";
+        _output << INDENT << "_pool_free(&" << pool << ", object);" << "\n";
+        _output << "}" << "\n\n";
+        
+    }
+    
+    /* Objects deleted through a pointer to a superclass are matched to a pool using their vtable */
+    _output << "static inline void " << syntax::poolRelease << "(void * object) {" << "\n\n";
+    _output << INDENT << "if (!object) {" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "void (**vtable)(void) = *(void (***)(void))object;" << "\n\n";
+    
+    for (const std::string & cls : pooled) {
+        _output << INDENT << "if (vtable == " << NameMangler::vtableName(cls) << ") {" << "\n";
+        _output << INDENT << INDENT << "_pool_free(&" << NameMangler::poolName(cls) << ", object);" << "\n";
+        _output << INDENT << INDENT << "return;" << "\n";
+        _output << INDENT << "}" << "\n";
+    }
+    
+    _output << "\n" << INDENT << "free(object);" << "\n\n";
+    _output << "}" << "\n\n";
+    
+    /* Statistics are only printed with --pool-stats, static functions mustn't be left unused */
+    if (not expr::isPoolStats()) {
+        return;
+    }
+    
+    _output << "static void " << syntax::poolStats << "(void) {" << "\n\n";
+    _output << INDENT << "_pool * pools[] = { ";
+    
+    for (size_t i = 0; i < pooled.size(); ++i) {
+        _output << (i ? ", " : "") << "&" << NameMangler::poolName(pooled[i]);
+    }
+    
+    _output << " };" << "\n\n";
+    _output << INDENT << "for (size_t i = 0; i < sizeof(pools) / sizeof(pools[0]); ++i) {" << "\n";
+    _output << INDENT << INDENT << "_pool * p = pools[i];" << "\n";
+    _output << INDENT << INDENT << "fprintf(stderr, \"pool %s: %zu allocations, %zu releases, "
+            << "%zu in use, %zu peak, %zu slabs\\n\"," << "\n";
+    _output << INDENT << INDENT << INDENT << "p->className, p->allocations, p->releases, "
+            << "p->inUse, p->peak, p->slabs);" << "\n";
+    _output << INDENT << "}" << "\n\n";
     _output << "}" << std::endl;
     
 }
 
-void Translator::objectCopyFun() {
+void Translator::instrumentation() {
     
-    _output << "\n" << "/* Object copy function - copies objects and preservers vtable ptrs */"
-            << "\n\n";
+    if (not expr::isInstrument()) {
+        return;
+    }
     
-    _output << "void " << syntax::copyObject << "(void * dest, void * orig, size_t objectSize) {\n\n";
+    const std::string & entry = syntax::profileEntry;
+    const std::string & frame = syntax::profileFrame;
+    
+    _output << "\n\n" << "/* Profiling */" << "\n\n";
+    
+    /* Each instrumented function owns a static entry, entries are linked into a list on first call */
+    /* Counters are updated using relaxed atomic adds, so calls from tasks and parallel loops count */
+    _output << "typedef struct " << entry << " {" << "\n";
+    _output << INDENT << "const char * name;" << "\n";
+    _output << INDENT << "const char * symbol;" << "\n";
+    _output << INDENT << "size_t branchCount;" << "\n";
+    _output << INDENT << "uint64_t (*branches)[2];" << "\n";
+    _output << INDENT << "uint64_t calls;" << "\n";
+    _output << INDENT << "uint64_t inclusive;" << "\n";
+    _output << INDENT << "uint64_t exclusive;" << "\n";
+    _output << INDENT << "struct " << entry << " * next;" << "\n";
+    _output << "} " << entry << ";" << "\n\n";
+    
+    /* Frames live on the stack of instrumented functions, time spent in callees is excluded from self time */
+    /* Recursion depth is counted per thread, only the outermost call of a thread adds to inclusive time  */
+    _output << "typedef struct " << frame << " {" << "\n";
+    _output << INDENT << entry << " * entry;" << "\n";
+    _output << INDENT << "uint64_t * depth;" << "\n";
+    _output << INDENT << "uint64_t start;" << "\n";
+    _output << INDENT << "uint64_t children;" << "\n";
+    _output << INDENT << "struct " << frame << " * parent;" << "\n";
+    _output << "} " << frame << ";" << "\n\n";
+    
+    _output << "static " << entry << " * _prof__entries = NULL;" << "\n";
+    
+    /* Functions which were never called have no entry in the list, but are still written to the profile */
+    _output << "static const char * _prof__symbols[] = { ";
+    for (AASTFunction * function : _aast.getFunctions()) {
+        if (function->isInstrumented()) {
+            _output << "\"" << function->getName() << "\", ";
+        }
+    }
+    _output << "NULL };" << "\n";
+    _output << "static _Thread_local " << frame << " * _prof__current = NULL;" << "\n\n";
+    
+    _output << "static inline uint64_t _prof_clock(void) {" << "\n";
+    _output << "#if defined(__x86_64__) || defined(__i386__)" << "\n";
+    _output << INDENT << "return __builtin_ia32_rdtsc();" << "\n";
+    _output << "#else" << "\n";
+    _output << INDENT << "struct timespec t;" << "\n";
+    _output << INDENT << "clock_gettime(CLOCK_MONOTONIC, &t);" << "\n";
+    _output << INDENT << "return (uint64_t)t.tv_sec * 1000000000u + (uint64_t)t.tv_nsec;" << "\n";
+    _output << "#endif" << "\n";
+    _output << "}" << "\n\n";
     
-    _output << INDENT << "dest += sizeof(void*);" << "\n";
-    _output << INDENT << "orig += sizeof(void*);" << "\n\n";
+    _output << "static inline void " << syntax::profileEnter << "(" << frame << " * frame, "
+            << entry << " * entry, uint64_t * depth) {" << "\n\n";
+    _output << INDENT << "if (!__atomic_fetch_add(&entry->calls, 1, __ATOMIC_RELAXED)) {" << "\n";
+    _output << INDENT << INDENT << "entry->next = __atomic_load_n(&_prof__entries, __ATOMIC_RELAXED);" << "\n";
+    _output << INDENT << INDENT << "while (!__atomic_compare_exchange_n(&_prof__entries, &entry->next, entry, 1, "
+            << "__ATOMIC_RELEASE, __ATOMIC_RELAXED));" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "*depth += 1;" << "\n\n";
+    _output << INDENT << "frame->entry = entry;" << "\n";
+    _output << INDENT << "frame->depth = depth;" << "\n";
+    _output << INDENT << "frame->children = 0;" << "\n";
+    _output << INDENT << "frame->parent = _prof__current;" << "\n";
+    _output << INDENT << "_prof__current = frame;" << "\n";
+    _output << INDENT << "frame->start = _prof_clock();" << "\n\n";
+    _output << "}" << "\n\n";
     
-    _output << INDENT << "objectSize -= sizeof(void*);" << "\n\n";
+    _output << "static inline void " << syntax::profileExit << "(" << frame << " * frame) {" << "\n\n";
+    _output << INDENT << "uint64_t elapsed = _prof_clock() - frame->start;" << "\n";
+    _output << INDENT << entry << " * entry = frame->entry;" << "\n\n";
+    _output << INDENT << "/* Time of recursive calls is already included in the outermost call */" << "\n";
+    _output << INDENT << "*frame->depth -= 1;" << "\n";
+    _output << INDENT << "if (!*frame->depth) {" << "\n";
+    _output << INDENT << INDENT << "__atomic_fetch_add(&entry->inclusive, elapsed, __ATOMIC_RELAXED);" << "\n";
+    _output << INDENT << "}" << "\n";
+    _output << INDENT << "__atomic_fetch_add(&entry->exclusive, elapsed - frame->children, __ATOMIC_RELAXED);" << "\n\n";
+    _output << INDENT << "if (frame->parent) {" << "\n";
+    _output << INDENT << INDENT << "frame->parent->children += elapsed;" << "\n";
+    _output << INDENT << "}" << "\n";
+    _output << INDENT << "_prof__current = frame->parent;" << "\n\n";
+    _output << "}" << "\n\n";
     
-    _output << INDENT << "memcpy(dest, orig, objectSize);" << "\n\n";
+    /* Counts executions of a condition and how many times it was true */
+    _output << "static inline int " << syntax::profileBranch << "(uint64_t * counter, int taken) {" << "\n";
+    _output << INDENT << "__atomic_fetch_add(&counter[0], 1, __ATOMIC_RELAXED);" << "\n";
+    _output << INDENT << "__atomic_fetch_add(&counter[1], taken, __ATOMIC_RELAXED);" << "\n";
+    _output << INDENT << "return taken;" << "\n";
+    _output << "}" << "\n\n";
     
+    _output << "static int _prof_compare(const void * a, const void * b) {" << "\n";
+    _output << INDENT << "uint64_t x = (*(" << entry << " * const *)a)->exclusive;" << "\n";
+    _output << INDENT << "uint64_t y = (*(" << entry << " * const *)b)->exclusive;" << "\n";
+    _output << INDENT << "return (x < y) - (x > y);" << "\n";
     _output << "}" << "\n\n";
     
+    /* Functions are sorted by self time, so the hottest functions come first */
+    _output << "static void " << syntax::profileDump << "(void) {" << "\n\n";
+    _output << INDENT << "size_t count = 0;" << "\n";
+    _output << INDENT << "for (" << entry << " * e = _prof__entries; e; e = e->next) {" << "\n";
+    _output << INDENT << INDENT << "count += 1;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << entry << " ** entries = malloc(count * sizeof(" << entry << " *));" << "\n";
+    _output << INDENT << "if (!entries) {" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "size_t i = 0;" << "\n";
+    _output << INDENT << "for (" << entry << " * e = _prof__entries; e; e = e->next) {" << "\n";
+    _output << INDENT << INDENT << "entries[i++] = e;" << "\n";
+    _output << INDENT << "}" << "\n";
+    _output << INDENT << "qsort(entries, count, sizeof(" << entry << " *), _prof_compare);" << "\n\n";
+    _output << INDENT << "fprintf(stderr, \"%-40s %12s %20s %20s\\n\", \"function\", \"calls\", "
+            << "\"inclusive cycles\", \"exclusive cycles\");" << "\n";
+    _output << INDENT << "for (i = 0; i < count; ++i) {" << "\n";
+    _output << INDENT << INDENT << "fprintf(stderr, \"%-40s %12llu %20llu %20llu\\n\", entries[i]->name, "
+            << "(unsigned long long)entries[i]->calls," << "\n";
+    _output << INDENT << INDENT << INDENT << "(unsigned long long)entries[i]->inclusive, "
+            << "(unsigned long long)entries[i]->exclusive);" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "free(entries);" << "\n\n";
+    
+    /* Counters are also stored in a file, which can be passed back to the compiler using --profile-use */
+    _output << INDENT << "const char * filename = getenv(\"KOBERIC_PROFILE\");" << "\n";
+    _output << INDENT << "FILE * file = fopen(filename ? filename : \"profile.data\", \"w\");" << "\n";
+    _output << INDENT << "if (!file) {" << "\n";
+    _output << INDENT << INDENT << "return;" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "for (" << entry << " * e = _prof__entries; e; e = e->next) {" << "\n";
+    _output << INDENT << INDENT << "fprintf(file, \"function %s %llu %llu %llu\\n\", e->symbol, "
+            << "(unsigned long long)e->calls," << "\n";
+    _output << INDENT << INDENT << INDENT << "(unsigned long long)e->inclusive, "
+            << "(unsigned long long)e->exclusive);" << "\n";
+    _output << INDENT << INDENT << "for (size_t b = 0; b < e->branchCount; ++b) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "fprintf(file, \"branch %s %zu %llu %llu\\n\", e->symbol, b, "
+            << "(unsigned long long)e->branches[b][0]," << "\n";
+    _output << INDENT << INDENT << INDENT << INDENT << "(unsigned long long)e->branches[b][1]);" << "\n";
+    _output << INDENT << INDENT << "}" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "for (const char ** s = _prof__symbols; *s; ++s) {" << "\n";
+    _output << INDENT << INDENT << "int called = 0;" << "\n";
+    _output << INDENT << INDENT << "for (" << entry << " * e = _prof__entries; e && !called; e = e->next) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "called = !strcmp(e->symbol, *s);" << "\n";
+    _output << INDENT << INDENT << "}" << "\n";
+    _output << INDENT << INDENT << "if (!called) {" << "\n";
+    _output << INDENT << INDENT << INDENT << "fprintf(file, \"function %s 0 0 0\\n\", *s);" << "\n";
+    _output << INDENT << INDENT << "}" << "\n";
+    _output << INDENT << "}" << "\n\n";
+    _output << INDENT << "fclose(file);" << "\n\n";
+    _output << "}" << std::endl;
+    
 }
 
 void Translator::main() {
@@ -146,6 +875,15 @@ void Translator::main() {
     _output << "\n" << "/* C Main Function */" << "\n" << "\n";
     
     _output << "int main(int argc, const char * argv[]) {" << "\n";
+    
+    if (expr::isPoolStats() and not pooledClasses().empty()) {
+        _output << INDENT << "atexit(" << syntax::poolStats << ");" << "\n";
+    }
+    
+    if (expr::isInstrument()) {
+        _output << INDENT << "atexit(" << syntax::profileDump << ");" << "\n";
+    }
+    
     _output << INDENT << NameMangler::mangleName("_globalVarInit", std::vector<parameter>()) << "();" << "\n";
     _output << INDENT << "return " << NameMangler::mangleName("main", std::vector<parameter>()) << "();" << "\n";
     _output << "}" << std::endl;
@@ -166,12 +904,20 @@ void Translator::translate() {
     
     libraries();
     typedefs();
+    vectorTypes();
+    bitCounts();
     memoryAllocator();
-    objectCopyFun();
+    taskScheduler();
+    coroutineRuntime();
     translateClasses();
+    objectCopyFunctions();
+    coroutineFrames();
     translateGlobals();
     translateFunctionDeclarations();
     translateVtables();
+    poolAllocators();
+    instrumentation();
+    taskFunctions();
     translateFunctions();
     
     main();
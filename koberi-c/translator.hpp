@@ -11,6 +11,9 @@
 
 #include <fstream>
 #include <vector>
+#include <map>
+#include <set>
+#include <algorithm>
 
 #include "traversable_ast.hpp"
 #include "analyzed_abstract_syntax_tree.hpp"
@@ -41,8 +44,36 @@ class Translator {
     /* V-table initializer function is passed via a pointer                               */
     void memoryAllocator();
     
-    /* Creates function which copies objects while preserving vtable pointers */
-    void objectCopyFun();
+    /* Creates functions which copy objects of each class while preserving vtable pointers */
+    /* Attributes are assigned one by one, so small copies can be inlined                 */
+    void objectCopyFunctions();
+    
+    /* Creates a work-stealing task scheduler, each worker thread owns a deque of tasks, it pushes and pops */
+    /* tasks at the bottom, idle workers steal the oldest tasks from the top of deques of other workers   */
+    /* Number of workers is read from KOBERIC_WORKERS, by default one worker runs on each processor       */
+    void taskScheduler();
+    
+    /* Creates the task struct, the function which runs the task and the spawn function of spawned functions */
+    void taskFunctions();
+    
+    /* Creates the coroutine header, which starts frames of all coroutines, and functions which resume */
+    /* coroutines and check if they finished                                                           */
+    void coroutineRuntime();
+    
+    /* Creates frame structs of async functions */
+    void coroutineFrames();
+    
+    /* Creates free-list pools and pool allocators for pooled classes                  */
+    /* Pool allocators store vtable pointers directly instead of calling initializers */
+    void poolAllocators();
+    
+    /* Returns names of all classes which are allocated from a pool */
+    std::vector<std::string> pooledClasses();
+    
+    /* Creates function entry/exit hooks, branch counters and the profile printed at exit of   */
+    /* instrumented programs, counters are also written to a file for use with --profile-use  */
+    /* Hooks measure cycles with rdtsc on x86, elsewhere monotonic clock nanoseconds are used */
+    void instrumentation();
     
     /* Output file stream */
     std::ofstream _output;
@@ -51,6 +82,10 @@ class Translator {
     void libraries();
     /* Outputs typedefs */
     void typedefs();
+    /* Outputs typedefs of SIMD vector types and macros implementing vector builtins */
+    void vectorTypes();
+    /* Outputs helpers implementing clz and ctz, which return the width of the operand for zero */
+    void bitCounts();
     /* Translates classes */
     void translateClasses();
     /* Translates forward function declarations */
@@ -59,7 +94,7 @@ class Translator {
     void translateVtables();
     /* Translates global variable declarations */
     void translateGlobals();
-    /* Translates functions and member functions */
+    /* Translates functions and member functions, hot functions first and cold functions last */
     void translateFunctions();
     
     
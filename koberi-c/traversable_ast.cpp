@@ -158,7 +158,55 @@ bool TraversableAbstractSyntaxTree::isDataType(const std::string & param) {
 bool TraversableAbstractSyntaxTree::isClass(const std::string & param) {
     
     /* Check if param isn't a primitive type. If it isn't, check if it is an existing type. */
-    return (not contains(_primitiveTypes, param)) and isDataType(param);
+    return (not contains(_primitiveTypes, param)) and isDataType(param) and not isSoa(param) and
+           not (syntax::isPointerType(param) and isSoa(param.substr(0, param.size() - 1)));
+    
+}
+
+bool TraversableAbstractSyntaxTree::isSoa(const std::string & type) {
+    
+    return _soaTypes.count(type);
+    
+}
+
+const std::string & TraversableAbstractSyntaxTree::getSoaClass(const std::string & type) {
+    
+    return _soaTypes.at(type);
+    
+}
+
+bool TraversableAbstractSyntaxTree::isPooled(const std::string & className) {
+    
+    if (not isClass(className) or syntax::isPointerType(className)) {
+        return false;
+    }
+    
+    /* Pools store objects in malloc'd blocks, which don't respect alignment set by :align */
+    return (expr::isPoolAllocation() or getClass(className).options.count("pool")) and not isOveraligned(className);
+    
+}
+
+bool TraversableAbstractSyntaxTree::isOveraligned(const std::string & className) {
+    
+    if (not isClass(className) or syntax::isPointerType(className)) {
+        return false;
+    }
+    
+    const _class & c = getClass(className);
+    
+    if (c.options.count("align") or (c.superClass != "" and isOveraligned(c.superClass))) {
+        return true;
+    }
+    
+    for (const parameter & attribute : c.attributes) {
+        
+        if (attribute.qualifiers.alignment or isOveraligned(attribute.type)) {
+            return true;
+        }
+        
+    }
+    
+    return false;
     
 }
 
@@ -12,6 +12,7 @@
 #include <stdio.h>
 
 #include "ast.hpp"
+#include "expressions.hpp"
 
 /* Tuples are a bit ugly in C++, structs look better so I'm using a struct       */
 /* Return type for getMethodReturnType(), which holds the methods return type    */
@@ -73,6 +74,19 @@ public:
     /* Checks if param is an existing class  */
     bool isClass(const std::string & param);
     
+    /* Checks if type is a struct-of-arrays container, pointers to containers aren't containers */
+    bool isSoa(const std::string & type);
+    /* Returns class stored in a struct-of-arrays container */
+    const std::string & getSoaClass(const std::string & type);
+    
+    /* Checks if objects of a class are allocated from a pool, either because the class */
+    /* was defined with the :pool option or because pool allocation is on globally     */
+    /* Over-aligned classes are never pooled                                            */
+    bool isPooled(const std::string & className);
+    
+    /* Checks if a class, it's superclasses or attributes stored by value use :align */
+    bool isOveraligned(const std::string & className);
+    
     /* Recursively checks if a class or it's superclasses inherit from a specified class */
     bool hasSuperclass(const std::string & className, const std::string & superClass);
     /* Recursively checks if a class or it's superclasses define specified method */
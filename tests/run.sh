@@ -0,0 +1,65 @@
+#!/bin/bash
+#
+#  run.sh
+#  Kobeři-C tests
+#
+#  Usage: tests/run.sh <compiler>
+#
+#  Every test is a Kobeři-C program. Programs with a .out file are compiled with gcc, their output
+#  must match the .out file. Programs with a .err file must be rejected by the compiler with the
+#  error message stored in the .err file.
+#
+
+if [ $# -ne 1 ]; then
+    echo "Usage: $0 <compiler>"
+    exit 2
+fi
+
+compiler=$(realpath "$1")
+tests=$(cd "$(dirname "$0")" && pwd)
+work=$(mktemp -d)
+failed=0
+
+trap 'rm -rf "$work"' EXIT
+
+for test in "$tests"/*.koberice; do
+    
+    name=$(basename "$test" .koberice)
+    cp "$test" "$work/$name.koberice"
+    
+    output=$("$compiler" "$work/$name.koberice" --std-path="$tests/../std" 2>&1)
+    
+    if [ -f "$tests/$name.err" ]; then
+        
+        if [[ "$output" == *"$(cat "$tests/$name.err")"* ]]; then
+            echo "ok   $name"
+        else
+            echo "FAIL $name: expected error $(cat "$tests/$name.err"), got: $output"
+            failed=1
+        fi
+        continue
+    fi
+    
+    if [[ "$output" != *"successfully"* ]]; then
+        echo "FAIL $name: $output"
+        failed=1
+        continue
+    fi
+    
+    if ! gcc -std=gnu11 -O2 -w -o "$work/$name" "$work/$name.c" -lm -pthread; then
+        echo "FAIL $name: generated C doesn't compile"
+        failed=1
+        continue
+    fi
+    
+    if timeout 10 "$work/$name" < /dev/null 2>&1 | diff "$tests/$name.out" - > "$work/$name.diff"; then
+        echo "ok   $name"
+    else
+        echo "FAIL $name:"
+        cat "$work/$name.diff"
+        failed=1
+    fi
+    
+done
+
+exit $failed